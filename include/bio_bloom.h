@@ -0,0 +1,61 @@
+/**
+ * @file bio_bloom.h
+ * @brief Filtro de Bloom para descartar genes que aparecen una sola vez.
+ *
+ * En datos con errores de secuenciación la mayoría de los genes aparece
+ * exactamente una vez, y cada uno de ellos crea un camino completo en el
+ * Trie. En el modo de solo conteo el filtro actúa como etapa previa: la
+ * primera aparición de un gen solo marca el filtro, y el gen entra al Trie
+ * (con conteo 2) recién en su segunda aparición.
+ *
+ * El filtro es probabilístico: con probabilidad cercana al 1 % un gen nuevo
+ * parece ya visto y entra al Trie con una aparición de más. Nunca se pierde
+ * un gen repetido.
+ */
+
+#ifndef BIO_BLOOM_H
+#define BIO_BLOOM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "bio_struct.h"
+
+/**
+ * @brief Bits del filtro por elemento esperado (≈1 % de falsos positivos).
+ */
+#define BLOOM_BITS_POR_ELEMENTO 10
+
+/**
+ * @brief Cantidad de funciones de hash (óptimo para 10 bits por elemento).
+ */
+#define BLOOM_HASHES 7
+
+/**
+ * @brief Crea un filtro vacío dimensionado para una cantidad de genes.
+ *
+ * @param elementos Cantidad esperada de genes distintos.
+ *
+ * @return El filtro, o NULL si no hubo memoria.
+ */
+FiltroBloom* crear_bloom(size_t elementos);
+
+/**
+ * @brief Libera un filtro.
+ *
+ * @param filtro Filtro a liberar (puede ser NULL).
+ */
+void liberar_bloom(FiltroBloom* filtro);
+
+/**
+ * @brief Marca un gen en el filtro e informa si ya estaba marcado.
+ *
+ * @param filtro  Filtro creado con crear_bloom().
+ * @param codigos Gen convertido a códigos 0..3.
+ * @param m       Cantidad de bases del gen.
+ *
+ * @return 1 si el gen (probablemente) ya había sido visto, 0 si es nuevo.
+ */
+int  bloom_visto(FiltroBloom* filtro, const uint8_t* codigos, int m);
+
+#endif // BIO_BLOOM_H
@@ -13,19 +13,22 @@
 #ifndef BIO_COMMANDS_H
 #define BIO_COMMANDS_H
 
+#include <stdio.h>
+
 #include "bio_struct.h"
 
 /** 
  * @brief Tamaño máximo permitido para una línea completa ingresada por el usuario.
  * Se utiliza para buffer seguro en la lectura del comando.
  */
-#define MAX_CMD 128
+#define MAX_CMD 1024
 
 /**
  * @brief Tamaño máximo de cada argumento individual de un comando.
- * Este valor previene desbordamientos en cadenas largas.
+ * Este valor previene desbordamientos en cadenas largas; limita también el
+ * gen de `bio search` a MAX_ARG - 1 bases.
  */
-#define MAX_ARG 64
+#define MAX_ARG 256
 
 /**
  * @struct Comando
@@ -33,18 +36,23 @@
  *
  * Un comando válido tiene la forma:
  * @code
- * bio <accion> <argumento>
+ * bio <accion> <argumento> [<argumento> [<argumento>]]
  * @endcode
  *
  * Ejemplos:
  * - bio start 4  
  * - bio read adn.txt  
  * - bio search ACTG  
+ * - bio extract 120 30  
+ * - bio compare a.txt b.txt all  
  */
 typedef struct {
     char cmd[16];       /**< Comando principal. Siempre debe ser "bio". */
-    char arg1[MAX_ARG]; /**< Subcomando (start, read, search, all, max, min, exit). */
+    char arg1[MAX_ARG]; /**< Subcomando (start, read, build, load, search, prefix, extract, compare, all, max, min, serve, exit). */
     char arg2[MAX_ARG]; /**< Argumento adicional. */
+    char arg3[MAX_ARG]; /**< Segundo argumento adicional (por ejemplo, el largo en `extract` o `--count-only` en `start`). */
+    char arg4[MAX_ARG]; /**< Tercer argumento adicional (por ejemplo, `all` en `compare`). */
+    int truncado;       /**< 1 si la línea o algún argumento no cabía y se recortó. */
 } Comando;
 
 /**
@@ -60,6 +68,26 @@ void mostrar_bienvenida(void);
  */
 void ejecutar_cli(void);
 
+/**
+ * @brief Separa una línea de texto en los componentes de un Comando.
+ *
+ * Es utilizada tanto por la CLI como por el servidor, de modo que ambos
+ * comparten exactamente la misma gramática `bio <accion> <argumento>`.
+ * Si un componente no cabe en su campo o sobran componentes, marca
+ * `truncado`: el comando no debe ejecutarse con argumentos recortados.
+ *
+ * @param linea Línea de texto sin salto de línea final.
+ * @param c     Estructura donde se almacenan cmd y arg1 a arg4.
+ */
+void parsear_comando(const char* linea, Comando *c);
+
+/**
+ * @brief Mensaje para un comando marcado como `truncado`.
+ *
+ * @param out Flujo de salida.
+ */
+void informar_truncado(FILE* out);
+
 /**
  * @brief Lee una línea ingresada por el usuario y separa los argumentos.
  *
@@ -69,8 +97,13 @@ void ejecutar_cli(void);
  * - el comando base,
  * - la acción,
  * - un argumento adicional (si existe).
+ *
+ * Una línea que no cabe en MAX_CMD se descarta hasta su salto y el comando
+ * queda marcado como `truncado`.
+ *
+ * @return 1 si se leyó una línea, 0 si se alcanzó el fin de la entrada.
  */
-void leer_comando(Comando *c);
+int  leer_comando(Comando *c);
 
 /**
  * @brief Ejecuta la acción solicitada por el usuario.
@@ -82,6 +115,20 @@ void leer_comando(Comando *c);
  */
 int  ejecutar_comando(Comando *c, Trie** trie);
 
+/**
+ * @brief Ejecuta un comando de solo lectura (search, prefix, extract, max, min, all).
+ *
+ * Estas acciones no modifican el Trie, por lo que pueden atenderse de forma
+ * concurrente desde varios hilos del servidor sobre el mismo índice.
+ *
+ * @param c    Comando ya separado.
+ * @param trie Trie previamente cargado.
+ * @param out  Flujo donde se escribe la respuesta.
+ *
+ * @return 1 si el comando era una consulta y fue atendido, 0 en caso contrario.
+ */
+int  ejecutar_consulta(Comando *c, Trie* trie, FILE* out);
+
 /* ------------------------------------------------------------------------- */
 /* ------------------------ PROTOTIPOS DE ACCIONES ------------------------- */
 /* ------------------------------------------------------------------------- */
@@ -89,46 +136,134 @@ int  ejecutar_comando(Comando *c, Trie** trie);
 /**
  * @brief Inicializa la estructura Trie con una profundidad dada.
  *
+ * Con `--count-only` las hojas solo cuentan apariciones (las consultas
+ * muestran `count=N` en lugar de posiciones) y con `--count-only bloom` los
+ * genes entran al Trie recién en su segunda aparición.
+ *
  * @param profundidad_str Cadena que representa el valor entero de m.
+ * @param opcion          Cadena vacía o "--count-only".
+ * @param filtro          Cadena vacía o "bloom" (solo junto a "--count-only").
  * @param trie            Doble puntero al Trie. Puede crear uno nuevo.
  */
-void bio_start(const char* profundidad_str, Trie** trie);
+void bio_start(const char* profundidad_str, const char* opcion, const char* filtro, Trie** trie);
 
 /**
  * @brief Lee un archivo de texto con la secuencia genética S e inserta todos los genes posibles.
  *
+ * Con la opción `sa` no se insertan genes en el Trie (y se descartan los de
+ * lecturas anteriores, que no corresponden a la nueva S): solo se guarda S
+ * empaquetada y se construyen el arreglo de sufijos y el FM-index, con lo que
+ * `bio search` acepta genes de hasta MAX_ARG - 1 bases. `bio prefix`, `bio all`,
+ * `bio max` y `bio min` necesitan el árbol e indican que no está construido.
+ *
  * @param filename Nombre del archivo a leer.
+ * @param opcion   Cadena vacía, o "sa" para construir también el FM-index.
  * @param trie     Trie ya inicializado mediante `bio start`.
  */
-void bio_read(const char* filename, Trie* trie);
+void bio_read(const char* filename, const char* opcion, Trie* trie);
+
+/**
+ * @brief Construye en disco el índice de un archivo sin superar un límite de memoria.
+ *
+ * Escribe `<archivo>.idx`, que luego se carga con `bio load`. Sirve para
+ * secuencias que no caben en memoria o superan MAX_SECUENCIA.
+ *
+ * @param filename   Archivo de la secuencia S.
+ * @param opcion     Debe ser "--mem-limit".
+ * @param limite_str Límite de memoria en MB.
+ * @param trie       Trie ya inicializado mediante `bio start` (define m).
+ */
+void bio_build(const char* filename, const char* opcion, const char* limite_str, Trie* trie);
+
+/**
+ * @brief Carga en el Trie un índice generado con `bio build`.
+ *
+ * La carga no respeta ningún límite de memoria: el Trie guarda todas las
+ * posiciones del índice. Solo se cargan los genes y sus posiciones; la
+ * secuencia no se conserva, por lo que `bio extract` no tiene datos sobre
+ * ella y `bio search` rechaza luego los genes más largos que m.
+ *
+ * @param filename Ruta del archivo de índice.
+ * @param trie     Trie inicializado con la misma m del índice.
+ */
+void bio_load(const char* filename, Trie* trie);
 
 /**
  * @brief Busca un gen específico dentro del Trie y muestra todas sus posiciones.
  *
+ * Si existe un FM-index, se utiliza para genes de cualquier largo (hasta
+ * MAX_ARG - 1 bases, el máximo de un argumento). Si no,
+ * y el gen es más largo que m, el Trie entrega las apariciones de sus
+ * primeras m bases y cada una se verifica contra la secuencia S almacenada.
+ * Esto solo es válido si todas las posiciones provienen de S: tras varias
+ * lecturas o un `bio load` esa búsqueda se rechaza con un mensaje.
+ *
  * @param trie Trie previamente cargado.
- * @param gen  Cadena de longitud m a buscar.
+ * @param gen  Cadena a buscar (de largo m o mayor si no hay FM-index).
+ * @param out  Flujo de salida (stdout en la CLI, el socket en el servidor).
+ */
+void bio_search(Trie* trie, const char* gen, FILE* out);
+
+/**
+ * @brief Lista los genes que comienzan con un prefijo dado junto con sus posiciones.
+ *
+ * @param trie    Trie previamente cargado.
+ * @param prefijo Cadena de longitud entre 1 y m.
+ * @param out     Flujo de salida.
+ */
+void bio_prefix(Trie* trie, const char* prefijo, FILE* out);
+
+/**
+ * @brief Muestra un fragmento de la secuencia S almacenada.
+ *
+ * Las bases que no eran A, C, G ni T se muestran como 'N'. Si el fragmento
+ * excede el final de S, se recorta.
+ *
+ * @param trie       Trie con la secuencia cargada.
+ * @param pos_str    Posición inicial del fragmento.
+ * @param largo_str  Cantidad de bases a mostrar.
+ * @param out        Flujo de salida.
+ */
+void bio_extract(Trie* trie, const char* pos_str, const char* largo_str, FILE* out);
+
+/**
+ * @brief Compara los genes de longitud m presentes en dos archivos.
+ *
+ * Construye un Trie temporal por archivo con la misma m del Trie actual y
+ * los recorre en paralelo, descendiendo solo por los subárboles presentes
+ * en ambos. Muestra la cantidad de genes compartidos, exclusivos de cada
+ * archivo y el índice de Jaccard.
+ *
+ * @param archivo_a Primer archivo de secuencia.
+ * @param archivo_b Segundo archivo de secuencia.
+ * @param opcion    Cadena vacía, o "all" para listar además los genes
+ *                  compartidos con sus posiciones en cada archivo.
+ * @param trie      Trie inicializado con `bio start` (aporta m; no se modifica).
  */
-void bio_search(Trie* trie, const char* gen);
+void bio_compare(const char* archivo_a, const char* archivo_b, const char* opcion, Trie* trie);
 
 /**
  * @brief Lista todos los genes presentes en el Trie junto con sus posiciones.
  *
  * @param trie Trie previamente cargado.
+ * @param out  Flujo de salida.
  */
-void bio_all(Trie* trie);
+void bio_all(Trie* trie, FILE* out);
 
 /**
  * @brief Muestra los genes con la mayor frecuencia en el Trie.
  *
  * @param trie Trie previamente cargado.
+ * @param out  Flujo de salida.
  */
-void bio_max(Trie* trie);
+void bio_max(Trie* trie, FILE* out);
 
 /**
  * @brief Muestra los genes con la menor frecuencia en el Trie.
  *
  * @param trie Trie previamente cargado.
+ * @param out  Flujo de salida.
  */
-void bio_min(Trie* trie);
+void bio_min(Trie* trie, FILE* out);
 
 #endif // BIO_COMMANDS_H
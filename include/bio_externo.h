@@ -0,0 +1,113 @@
+/**
+ * @file bio_externo.h
+ * @brief Construcción del índice en memoria externa con un límite de memoria,
+ *        y lectura del archivo de índice resultante.
+ *
+ * Cuando las posiciones de todos los genes no caben en memoria, el índice se
+ * construye por partes:
+ * 1. Se recorre el archivo una vez y cada gen (codificado en un entero de
+ *    64 bits) se escribe en una cubeta temporal en disco según sus primeras
+ *    bases (a lo sumo 4, es decir, EXTERNO_MAX_CUBETAS cubetas).
+ * 2. Cada cubeta se ordena en memoria si cabe en el límite indicado; si no
+ *    (archivos grandes o secuencias muy repetitivas), se ordena en disco en
+ *    corridas del tamaño del límite, guardadas en un único archivo temporal
+ *    e intercaladas de a 16 hacia un segundo archivo. El resultado se agrega
+ *    al archivo de índice final.
+ *
+ * Como las cubetas se procesan en orden de prefijo, el archivo final queda
+ * ordenado por gen. Su formato (en el orden de bytes de la máquina) es:
+ * @code
+ * "ADNIDX1\0" | m (uint32) | 0 (uint32) | genes (uint64) | bases (uint64)
+ * por cada gen: código (uint64) | cantidad (uint32) | posiciones (uint32 × cantidad)
+ * @endcode
+ */
+
+#ifndef BIO_EXTERNO_H
+#define BIO_EXTERNO_H
+
+#include <stddef.h>
+#include <limits.h>
+
+#include "bio_struct.h"
+
+/**
+ * @brief Mayor m admitido: el gen debe caber en un código de 64 bits.
+ */
+#define EXTERNO_MAX_M 32
+
+/**
+ * @brief Cantidad máxima de cubetas temporales abiertas a la vez (por pasada).
+ */
+#define EXTERNO_MAX_CUBETAS 256
+
+/**
+ * @brief Mayor tamaño de archivo de entrada, en bytes.
+ *
+ * El Trie guarda las posiciones como int, así que S puede tener a lo sumo
+ * INT_MAX bases (unos 2.100 millones); como cada base ocupa al menos un
+ * byte, el tamaño del archivo se valida antes de recorrerlo. Un genoma
+ * humano completo (~3.100 millones de bases) debe dividirse, por ejemplo,
+ * por cromosoma.
+ */
+#define EXTERNO_MAX_BYTES ((long)INT_MAX)
+
+/**
+ * @brief Firma al inicio de todo archivo de índice.
+ */
+#define INDICE_FIRMA "ADNIDX1"
+
+/**
+ * @struct ResumenExterno
+ * @brief Datos informativos de una construcción externa.
+ */
+typedef struct {
+    size_t bases;    /**< Bases leídas del archivo. */
+    size_t genes;    /**< Genes distintos escritos en el índice. */
+    int cubetas;     /**< Cantidad total de cubetas (4^b para b bases de prefijo). */
+    int pasadas;     /**< Veces que se recorrió el archivo de entrada. */
+    size_t mayor_cubeta; /**< Bytes de la mayor cubeta. */
+    int en_disco;    /**< Cubetas que excedían el límite y se ordenaron en disco. */
+} ResumenExterno;
+
+/**
+ * @brief Construye un archivo de índice sin superar un límite de memoria.
+ *
+ * A diferencia de cargar_secuencia(), la secuencia no está limitada a
+ * MAX_SECUENCIA: el archivo se procesa por bloques y solo se exige que no
+ * supere EXTERNO_MAX_BYTES, para que las posiciones quepan en un int. Ningún
+ * ordenamiento usa más de `limite`
+ * bytes; aparte quedan los bloques de lectura y los buffers de E/S de los
+ * archivos temporales.
+ *
+ * @param archivo Archivo de la secuencia S.
+ * @param salida  Ruta del archivo de índice a escribir.
+ * @param m       Largo de los genes (1..EXTERNO_MAX_M).
+ * @param limite  Memoria máxima en bytes para ordenar una cubeta.
+ * @param resumen Recibe datos de la construcción (puede ser NULL).
+ *
+ * @return CARGA_OK, CARGA_ERROR_TAMANO si el archivo supera
+ *         EXTERNO_MAX_BYTES (antes de escribir nada), u otro código CARGA_ERROR_*.
+ */
+int construir_indice_externo(const char* archivo, const char* salida, int m,
+                             size_t limite, ResumenExterno* resumen);
+
+/**
+ * @brief Carga en el Trie un archivo de índice generado por
+ *        construir_indice_externo().
+ *
+ * @param trie    Trie inicializado con la misma m del índice.
+ * @param archivo Ruta del archivo de índice.
+ *
+ * La carga no tiene límite de memoria: el Trie resultante guarda todas las
+ * posiciones del índice, igual que tras cargar_secuencia().
+ *
+ * Antes de reservar memoria se valida la cabecera (firma, 1 <= m <=
+ * EXTERNO_MAX_M, campo reservado en 0) y, en cada registro, que el código
+ * use solo 2·m bits y que sus posiciones quepan en lo que resta del archivo.
+ *
+ * @return CARGA_OK, CARGA_ERROR_FORMATO si el archivo no es un índice válido
+ *         o su m no coincide, u otro código CARGA_ERROR_*.
+ */
+int cargar_indice(Trie* trie, const char* archivo);
+
+#endif // BIO_EXTERNO_H
@@ -0,0 +1,55 @@
+/**
+ * @file bio_fm.h
+ * @brief Índice alternativo al Trie: arreglo de sufijos (SA-IS) y FM-index
+ *        sobre toda la secuencia S, para buscar genes de cualquier longitud.
+ *
+ * El Trie solo responde genes de longitud exactamente m. Este módulo
+ * construye, a partir de la secuencia empaquetada que conserva el Trie:
+ * - El arreglo de sufijos en tiempo lineal mediante SA-IS.
+ * - La transformada de Burrows-Wheeler y una tabla de ocurrencias por bloques.
+ *
+ * La memoria total es de aproximadamente 5,4 bytes por base.
+ */
+
+#ifndef BIO_FM_H
+#define BIO_FM_H
+
+#include "bio_struct.h"
+
+/**
+ * @brief Cantidad de símbolos de la BWT entre dos conteos almacenados.
+ */
+#define FM_BLOQUE 64
+
+/**
+ * @brief Construye el FM-index de la secuencia almacenada en el Trie.
+ *
+ * Reemplaza el índice anterior, si existía.
+ *
+ * @param trie Trie con una secuencia ya cargada mediante cargar_secuencia().
+ *
+ * @return CARGA_OK, o CARGA_ERROR_MEMORIA si no hay memoria suficiente.
+ */
+int  construir_indice_fm(Trie* trie);
+
+/**
+ * @brief Libera toda la memoria asociada a un FM-index.
+ *
+ * @param fm Índice a liberar (puede ser NULL).
+ */
+void liberar_indice_fm(IndiceFM* fm);
+
+/**
+ * @brief Busca todas las apariciones de un gen en la secuencia indexada.
+ *
+ * @param fm         Índice construido con construir_indice_fm().
+ * @param codigos    Gen convertido a códigos 0..3 (A, C, G, T).
+ * @param largo      Cantidad de bases del gen.
+ * @param posiciones Recibe un arreglo nuevo con las posiciones en orden
+ *                   creciente (NULL si no hay apariciones). Debe liberarse con free().
+ *
+ * @return Cantidad de apariciones, o -1 si no hubo memoria para el resultado.
+ */
+int  buscar_fm(const IndiceFM* fm, const uint8_t* codigos, int largo, int** posiciones);
+
+#endif // BIO_FM_H
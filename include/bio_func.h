@@ -4,7 +4,7 @@
  *        utilizado para almacenar genes en la secuencia de ADN.
  *
  * Este archivo contiene las funciones encargadas de:
- * - Crear el Trie completo de profundidad m.
+ * - Crear el Trie de profundidad m.
  * - Liberar toda la memoria asociada.
  * - Insertar genes detectados en la secuencia.
  * - Navegar mediante índices derivados de caracteres A, C, G y T.
@@ -13,36 +13,93 @@
 #ifndef BIO_FUNC_H
 #define BIO_FUNC_H
 
+#include <stdint.h>
+
 #include "bio_struct.h"
 
+/**
+ * @brief Cantidad máxima de bases leídas desde un archivo de secuencia.
+ */
+#define MAX_SECUENCIA 100000
+
+/** @brief La secuencia se cargó correctamente. */
+#define CARGA_OK             0
+/** @brief No se pudo abrir el archivo de la secuencia. */
+#define CARGA_ERROR_ARCHIVO -1
+/** @brief La secuencia es más corta que la profundidad m. */
+#define CARGA_ERROR_LARGO   -2
+/** @brief No se pudo reservar memoria durante la carga. */
+#define CARGA_ERROR_MEMORIA -3
+/** @brief El archivo de índice no tiene el formato esperado o su m no coincide. */
+#define CARGA_ERROR_FORMATO -4
+/** @brief No se pudo escribir un archivo temporal o de salida. */
+#define CARGA_ERROR_ESCRITURA -5
+/** @brief El archivo tiene más bases de las que admiten las posiciones (int). */
+#define CARGA_ERROR_TAMANO  -6
+
 /* ------------------------------------------------------------------------- */
 /* -------------------------- CREACIÓN DEL TRIE ---------------------------- */
 /* ------------------------------------------------------------------------- */
 
 /**
- * @brief Crea de forma recursiva los nodos del Trie 4-ario hasta alcanzar
- *        la profundidad especificada.
+ * @brief Crea un nodo vacío del Trie 4-ario.
  *
- * Esta función construye el árbol completo antes de insertar cualquier gen.
- * Los nodos hoja se caracterizan por tener `nivel_actual == profundidad_total`.
+ * El Trie es disperso: los nodos se crean durante la inserción, solo para
+ * los genes que efectivamente aparecen en la secuencia. Así la memoria
+ * depende del largo de S y no de las 4^m combinaciones posibles.
  *
- * @param nivel_actual       Nivel actual dentro del Trie (comienza en 0).
- * @param profundidad_total  Altura máxima del árbol, también llamada m.
+ * @param es_hoja 1 si el nodo corresponde al nivel m.
  *
- * @return Puntero al nodo raíz del subárbol creado, o NULL en caso de fallo.
+ * @return Puntero al nodo creado, o NULL en caso de fallo.
  */
-Nodo* crear_nodo_recursivo(int nivel_actual, int profundidad_total);
+Nodo* crear_nodo(int es_hoja);
 
 /**
- * @brief Inicializa completamente un Trie construyendo su árbol interno.
+ * @brief Inicializa un Trie vacío de profundidad m.
  *
  * @param trie        Puntero al Trie a inicializar.
  * @param profundidad Profundidad del árbol, equivalente al tamaño m del gen.
  *
- * Se crea un Trie completamente expandido, con todos los nodos necesarios
- * para representar todas las combinaciones posibles de genes de longitud m.
+ * Solo se crea la raíz; los demás nodos se agregan al insertar genes.
+ * Si m tiene rutinas especializadas (ver bio_kernels.h) quedan
+ * seleccionadas en `trie->kernel`.
+ *
+ * @return 0 si se inicializó, -1 si no hubo memoria para la raíz.
+ */
+int   inicializar_trie(Trie* trie, int profundidad);
+
+/**
+ * @brief Activa el modo de solo conteo en un Trie recién inicializado.
+ *
+ * Las hojas dejan de guardar posiciones y solo cuentan apariciones, lo que
+ * basta para `bio max`, `bio min` y los histogramas de frecuencia. Con
+ * filtro, la primera aparición de cada gen se registra solo en un filtro de
+ * Bloom (ver bio_bloom.h) dimensionado para @ref MAX_SECUENCIA genes, y el
+ * gen entra al Trie en su segunda aparición.
+ *
+ * @param trie       Trie inicializado y aún vacío.
+ * @param con_filtro 1 para usar el filtro de Bloom.
+ *
+ * @return 0 si se activó, -1 si no hubo memoria para el filtro.
  */
-void  inicializar_trie(Trie* trie, int profundidad);
+int   activar_conteo(Trie* trie, int con_filtro);
+
+/**
+ * @brief Estima la memoria máxima que ocupará el Trie al indexar una secuencia.
+ *
+ * Considera que el nivel d tiene a lo sumo min(4^d, bases) nodos, una
+ * posición por base, el costo de cada bloque de malloc (cabecera y
+ * redondeo), la copia empaquetada de S y los buffers temporales de la
+ * lectura. Es una aproximación: no incluye la fragmentación del heap que
+ * producen los realloc. Permite advertir al usuario antes de reservar memoria.
+ *
+ * @param profundidad Profundidad m del Trie.
+ * @param bases       Cantidad de bases de la secuencia a indexar.
+ * @param solo_conteo 1 si el Trie está en modo de solo conteo (sin posiciones).
+ *
+ * @return Cantidad estimada de bytes.
+ */
+double estimar_memoria_trie(int profundidad, size_t bases, int solo_conteo);
 
 /* ------------------------------------------------------------------------- */
 /* --------------------------- LIBERACIÓN MEMORIA -------------------------- */
@@ -94,7 +151,7 @@ int   char_a_indice(char c);
  *
  * La cadena `secuencia` debe tener longitud igual a `trie->profundidad`.
  * Esta función:
- * - Navega el Trie desde la raíz,
+ * - Navega el Trie desde la raíz, creando los nodos que falten,
  * - Localiza la hoja del gen,
  * - Amplía el arreglo de posiciones mediante realloc,
  * - Inserta la posición al final.
@@ -105,4 +162,108 @@ int   char_a_indice(char c);
  */
 void  insertar_en_trie(Trie* trie, const char* secuencia, int posicion);
 
+/**
+ * @brief Inserta una aparición de un gen ya convertido a códigos 0..3.
+ *
+ * Equivalente a insertar_en_trie(), pero evita convertir cada carácter:
+ * el cargador obtiene los códigos de toda la secuencia de una sola vez.
+ *
+ * @param trie      Trie ya inicializado.
+ * @param codigos   Arreglo de m códigos (A→0, C→1, G→2, T→3), todos válidos.
+ * @param posicion  Posición dentro de la secuencia S en la cual inicia el gen.
+ *
+ * Si el Trie tiene filtro de Bloom, un gen nuevo solo se inserta en su
+ * segunda aparición.
+ *
+ * @return 0 si se insertó, -1 si no hubo memoria.
+ */
+int   insertar_codigos(Trie* trie, const uint8_t* codigos, int posicion);
+
+/**
+ * @brief Inserta de una vez varias apariciones de un mismo gen.
+ *
+ * El arreglo de posiciones de la hoja se amplía con un único realloc, lo
+ * que conviene al cargar un índice ya agrupado por gen.
+ *
+ * @param trie       Trie ya inicializado.
+ * @param codigos    Arreglo de m códigos válidos.
+ * @param posiciones Posiciones a agregar, en orden.
+ * @param cantidad   Cantidad de posiciones.
+ *
+ * @return 0 si se insertó, -1 si no hubo memoria (la hoja queda como estaba).
+ */
+int   insertar_posiciones(Trie* trie, const uint8_t* codigos, const int* posiciones, int cantidad);
+
+/**
+ * @brief Agrega apariciones a una hoja ya ubicada (o solo las cuenta en el
+ *        modo de solo conteo).
+ *
+ * Es el último paso de toda inserción; las rutinas especializadas de
+ * bio_kernels.c la usan tras descender por el Trie.
+ *
+ * @param trie       Trie al que pertenece la hoja.
+ * @param hoja       Hoja del gen.
+ * @param posiciones Posiciones a agregar.
+ * @param cantidad   Cantidad de posiciones.
+ *
+ * @return 0 si se agregaron, -1 si no hubo memoria (la hoja queda como estaba).
+ */
+int   agregar_posiciones(Trie* trie, Nodo* hoja, const int* posiciones, int cantidad);
+
+/* ------------------------------------------------------------------------- */
+/* --------------------------- CARGA DE SECUENCIAS ------------------------- */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @brief Lee la secuencia S desde un archivo e inserta todos sus genes de longitud m.
+ *
+ * La lectura ignora saltos de línea, normaliza a mayúsculas y considera como
+ * máximo @ref MAX_SECUENCIA bases. Las ventanas que contienen caracteres
+ * distintos de A, C, G y T no se insertan.
+ *
+ * La secuencia leída queda almacenada en el Trie (2 bits por base más una
+ * máscara de bases inválidas), reemplazando la de una lectura anterior.
+ * El FM-index de la secuencia anterior, si existía, se descarta. Las
+ * posiciones ya insertadas se conservan, y en ese caso se marca
+ * `trie->fuentes_mixtas` porque dejan de corresponder a la secuencia
+ * almacenada. No imprime mensajes, de modo que puede invocarse tanto desde
+ * la CLI como desde un hilo de reconstrucción.
+ *
+ * @param trie     Trie ya inicializado.
+ * @param filename Ruta del archivo a leer.
+ *
+ * @return @ref CARGA_OK o uno de los códigos de error `CARGA_ERROR_*`.
+ */
+int   cargar_secuencia(Trie* trie, const char* filename);
+
+/**
+ * @brief Lee la secuencia S desde un archivo y la almacena en el Trie sin
+ *        insertar sus genes.
+ *
+ * Realiza la misma lectura que cargar_secuencia() (incluido el reemplazo de
+ * la secuencia anterior y el descarte de su FM-index), pero no inserta
+ * genes y descarta los de lecturas anteriores, que ya no corresponden a S:
+ * el árbol queda vacío. Es la lectura del modo `bio read <archivo> sa`, en
+ * el que las búsquedas se responden con el FM-index.
+ *
+ * @param trie     Trie ya inicializado.
+ * @param filename Ruta del archivo a leer.
+ *
+ * @return @ref CARGA_OK o uno de los códigos de error `CARGA_ERROR_*`.
+ */
+int   leer_secuencia(Trie* trie, const char* filename);
+
+/**
+ * @brief Obtiene la base de la secuencia S almacenada en el Trie.
+ *
+ * Lee la copia empaquetada a 2 bits que conserva cargar_secuencia(), por lo
+ * que no requiere volver a abrir el archivo.
+ *
+ * @param trie     Trie con una secuencia ya cargada.
+ * @param posicion Posición dentro de S, menor que `trie->largo`.
+ *
+ * @return Código 0..3 (A, C, G, T) o BASE_INVALIDA si la base no es válida.
+ */
+int   base_en(const Trie* trie, size_t posicion);
+
 #endif // BIO_FUNC_H
@@ -0,0 +1,42 @@
+/**
+ * @file bio_kernels.h
+ * @brief Rutinas de inserción y búsqueda en el Trie especializadas en tiempo
+ *        de compilación para valores frecuentes de m.
+ *
+ * El camino genérico recorre `for (i = 0; i < trie->profundidad; i++)` con
+ * la profundidad conocida solo en ejecución. Para cada m entre
+ * @ref KERNEL_MIN_M y @ref KERNEL_MAX_M se genera una copia en la que m es
+ * constante, de modo que el compilador:
+ * - desenrolla por completo el descenso por el Trie,
+ * - mantiene la ventana deslizante en un único código de 64 bits
+ *   (2 bits por base) con la máscara calculada en compilación.
+ *
+ * inicializar_trie() elige la rutina según m; fuera del rango (o compilando
+ * con `-DBIO_SIN_ESPECIALIZAR`) se usa el camino genérico.
+ */
+
+#ifndef BIO_KERNELS_H
+#define BIO_KERNELS_H
+
+#include "bio_struct.h"
+
+/**
+ * @brief Menor m con rutinas especializadas.
+ */
+#define KERNEL_MIN_M 4
+
+/**
+ * @brief Mayor m con rutinas especializadas (la ventana cabe en 64 bits).
+ */
+#define KERNEL_MAX_M 32
+
+/**
+ * @brief Obtiene las rutinas especializadas para una profundidad.
+ *
+ * @param m Profundidad del Trie.
+ *
+ * @return Las rutinas para m, o NULL si m no tiene versión especializada.
+ */
+const KernelTrie* seleccionar_kernel(int m);
+
+#endif // BIO_KERNELS_H
@@ -0,0 +1,64 @@
+/**
+ * @file bio_server.h
+ * @brief Modo servidor del Analizador de ADN: atiende consultas sobre un
+ *        socket local (Unix domain socket) reutilizando un índice ya cargado.
+ *
+ * El índice se construye una única vez con `bio start` y `bio read`, y luego
+ * `bio serve <ruta>` deja el programa escuchando en la ruta indicada. Cada
+ * línea recibida sigue la misma gramática de la CLI:
+ * @code
+ * bio search ACTG
+ * bio prefix AC
+ * bio max
+ * @endcode
+ *
+ * Un grupo fijo de hilos (thread pool) atiende las conexiones en paralelo.
+ * Como las consultas no modifican el Trie, todos los hilos lo comparten sin
+ * necesidad de bloqueos.
+ *
+ * `bio reload <archivo>` reconstruye el índice en un hilo de fondo mientras
+ * las consultas siguen respondiendo con el anterior; al terminar, el índice
+ * nuevo se publica con un intercambio atómico de puntero y el viejo se
+ * libera cuando ningún hilo lo está leyendo.
+ */
+
+#ifndef BIO_SERVER_H
+#define BIO_SERVER_H
+
+#include "bio_struct.h"
+
+/**
+ * @brief Cantidad de hilos trabajadores que atienden pedidos.
+ *
+ * Un trabajador responde una línea y devuelve la conexión, por lo que este
+ * valor limita las consultas simultáneas, no los clientes conectados.
+ */
+#define SERVER_HILOS 4
+
+/**
+ * @brief Cantidad máxima de conexiones abiertas a la vez; las siguientes se rechazan.
+ */
+#define SERVER_COLA 64
+
+/**
+ * @brief Segundos que puede demorar el envío de una respuesta antes de cerrar
+ *        la conexión (cliente que no lee lo que recibe).
+ */
+#define SERVER_ESPERA_ENVIO 5
+
+/**
+ * @brief Inicia el servidor de consultas sobre un socket local.
+ *
+ * La función bloquea hasta que algún cliente envíe `bio shutdown`. Dentro de
+ * una conexión, `bio exit` cierra solo esa conexión. Cada respuesta termina
+ * con una línea vacía para que el cliente sepa dónde termina.
+ *
+ * @param ruta Ruta del socket a crear (se elimina al terminar).
+ * @param trie Doble puntero al Trie cargado mediante `bio read`. Al terminar
+ *             apunta al índice vigente, que puede ser uno recargado.
+ *
+ * @return 0 si el servidor terminó correctamente, -1 en caso de error.
+ */
+int bio_serve(const char* ruta, Trie** trie);
+
+#endif // BIO_SERVER_H
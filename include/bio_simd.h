@@ -0,0 +1,68 @@
+/**
+ * @file bio_simd.h
+ * @brief Rutinas vectorizadas para el tratamiento de bases nitrogenadas.
+ *
+ * Este módulo agrupa las operaciones que se aplican carácter a carácter
+ * sobre la secuencia S antes de extraer los genes:
+ * - Normalizar a mayúsculas y eliminar saltos de línea.
+ * - Convertir cada base a su código 0..3 (A, C, G, T) detectando inválidas.
+ * - Empaquetar los códigos a 2 bits por base.
+ *
+ * En procesadores x86-64 se utilizan instrucciones SSE2 (16 bases por
+ * instrucción) y, si el procesador lo permite, AVX2 (32 bases). En cualquier
+ * otra plataforma se utiliza una versión escalar equivalente.
+ */
+
+#ifndef BIO_SIMD_H
+#define BIO_SIMD_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Código asignado a cualquier carácter distinto de A, C, G o T.
+ */
+#define BASE_INVALIDA 4
+
+/**
+ * @brief Convierte a mayúsculas y elimina los caracteres '\n' y '\r'.
+ *
+ * Puede operar en el mismo arreglo (`dst == src`), ya que nunca escribe
+ * por delante de lo que ya leyó.
+ *
+ * @param dst Arreglo de destino, de al menos n bytes.
+ * @param src Texto de entrada.
+ * @param n   Cantidad de bytes de entrada.
+ *
+ * @return Cantidad de bytes escritos en dst.
+ */
+size_t normalizar_bases(char* dst, const char* src, size_t n);
+
+/**
+ * @brief Convierte bases en mayúsculas a sus códigos (A→0, C→1, G→2, T→3).
+ *
+ * Los caracteres que no corresponden a una base válida reciben
+ * @ref BASE_INVALIDA.
+ *
+ * @param codigos Arreglo de destino de n bytes.
+ * @param s       Bases ya normalizadas.
+ * @param n       Cantidad de bases.
+ *
+ * @return Cantidad de caracteres inválidos encontrados (0 si todos son válidos).
+ */
+size_t codificar_bases(uint8_t* codigos, const char* s, size_t n);
+
+/**
+ * @brief Empaqueta códigos 0..3 a 2 bits por base (4 bases por byte).
+ *
+ * La base i queda en los bits `2*(i%4)` y `2*(i%4)+1` del byte `i/4`.
+ * Los códigos inválidos se almacenan como 0, por lo que deben registrarse
+ * aparte si se necesita distinguirlos.
+ *
+ * @param dst     Arreglo de destino de (n + 3) / 4 bytes.
+ * @param codigos Códigos de entrada.
+ * @param n       Cantidad de bases.
+ */
+void   empaquetar_2bits(uint8_t* dst, const uint8_t* codigos, size_t n);
+
+#endif // BIO_SIMD_H
@@ -8,18 +8,25 @@
  * - @ref Trie : representa el árbol completo utilizado para indexar genes
  *               de longitud m dentro de la secuencia genética S.
  *
- * El árbol 4-ario se utiliza para almacenar todas las combinaciones posibles
- * de secuencias génicas de longitud fija, siguiendo el modelo de A, C, G y T.
+ * El árbol 4-ario se utiliza para almacenar las secuencias génicas de
+ * longitud fija presentes en S, siguiendo el modelo de A, C, G y T.
+ *
+ * Opcionalmente se declara también @ref IndiceFM, un índice sobre toda la
+ * secuencia que permite buscar genes de cualquier longitud.
  */
 
 #ifndef BIO_STRUCT_H
 #define BIO_STRUCT_H
 
+#include <stddef.h>
+#include <stdint.h>
+
 /**
  * @struct Nodo
  * @brief Representa un nodo del Trie utilizado para almacenar genes.
  *
- * Cada nodo posee exactamente 4 hijos, uno por cada base nitrogenada:
+ * Cada nodo posee hasta 4 hijos, uno por cada base nitrogenada (NULL si
+ * ningún gen presente continúa por esa base):
  * - 〈0〉 → A  
  * - 〈1〉 → C  
  * - 〈2〉 → G  
@@ -27,6 +34,8 @@
  *
  * Los nodos hoja (nivel == profundidad m) almacenan dinámicamente las
  * posiciones dentro de la secuencia S donde aparece el gen correspondiente.
+ * En el modo de solo conteo `posiciones` queda en NULL y `numPosiciones`
+ * lleva únicamente la cantidad de apariciones.
  */
 typedef struct Nodo 
 {
@@ -36,18 +45,80 @@ typedef struct Nodo
     int numPosiciones;     /**< Cantidad de posiciones almacenadas en el arreglo. */
 } Nodo;
 
+/**
+ * @brief Cantidad de símbolos del texto indexado por el FM-index:
+ *        terminador, A, C, G, T y base inválida.
+ */
+#define FM_SIMBOLOS 6
+
+/**
+ * @struct IndiceFM
+ * @brief Arreglo de sufijos y FM-index de la secuencia S completa.
+ *
+ * El texto indexado es S seguida de un terminador, codificado como
+ * 0 = terminador, 1..4 = A, C, G, T y 5 = base inválida. A diferencia del
+ * Trie, no depende de m: la búsqueda hacia atrás sobre la transformada de
+ * Burrows-Wheeler encuentra un gen de cualquier longitud en O(|gen|) pasos
+ * y el arreglo de sufijos entrega sus posiciones.
+ */
+typedef struct IndiceFM
+{
+    int* sa;                 /**< Arreglo de sufijos (largo entradas). */
+    uint8_t* bwt;            /**< Transformada de Burrows-Wheeler del texto. */
+    uint32_t* ocurrencias;   /**< Conteo de cada símbolo antes de cada bloque de la BWT. */
+    size_t c[FM_SIMBOLOS];   /**< Cantidad de símbolos menores que cada símbolo. */
+    size_t largo;            /**< Largo del texto indexado (|S| + 1). */
+} IndiceFM;
+
+/**
+ * @struct FiltroBloom
+ * @brief Arreglo de bits de un filtro de Bloom (ver bio_bloom.h).
+ */
+typedef struct FiltroBloom
+{
+    uint64_t* bits;     /**< Bits del filtro, 64 por palabra. */
+    size_t num_bits;    /**< Cantidad de bits utilizables. */
+} FiltroBloom;
+
+struct Trie;
+
+/**
+ * @struct KernelTrie
+ * @brief Rutinas de inserción y búsqueda especializadas para un m fijo
+ *        (ver bio_kernels.h).
+ */
+typedef struct KernelTrie
+{
+    int m;                                                               /**< Profundidad para la que fue generado. */
+    int (*indexar)(struct Trie* trie, const uint8_t* codigos, size_t largo); /**< Inserta todas las ventanas de largo m. */
+    Nodo* (*buscar)(const struct Trie* trie, const uint8_t* codigos);    /**< Hoja de un gen de m códigos, o NULL. */
+} KernelTrie;
+
 /**
  * @struct Trie
  * @brief Representa el árbol 4-ario completo para la indexación de genes.
  *
  * La profundidad del Trie corresponde al tamaño m de los genes que se desean
  * detectar dentro de la secuencia genética S. Cada camino desde la raíz hasta
- * un nodo hoja representa un posible gen de longitud m.
+ * un nodo hoja representa un gen de longitud m presente en S.
+ *
+ * Además del árbol, el Trie conserva la última secuencia S leída empaquetada
+ * a 2 bits por base (4 veces menos que un carácter por base). Las bases que
+ * no son A, C, G ni T se guardan como A y se marcan en `mascara_n`.
  */
 typedef struct Trie 
 {
     Nodo* raiz;         /**< Puntero al nodo raíz del Trie. */
     int profundidad;    /**< Profundidad total m (tamaño del gen). */
+    size_t distintos;   /**< Cantidad de genes distintos presentes (hojas con posiciones). */
+    uint8_t* secuencia; /**< Secuencia S empaquetada, 4 bases por byte (NULL si no se ha leído). */
+    uint8_t* mascara_n; /**< Bit i activo si la base i de S no es A, C, G ni T. */
+    size_t largo;       /**< Cantidad de bases de la secuencia S almacenada. */
+    IndiceFM* fm;       /**< FM-index de S (NULL si no se construyó con `bio read <archivo> sa`). */
+    int solo_conteo;    /**< 1 si las hojas solo cuentan apariciones (`bio start m --count-only`). */
+    FiltroBloom* bloom; /**< Filtro de primeras apariciones (NULL si no se usa). */
+    int fuentes_mixtas; /**< 1 si hay posiciones de varias lecturas o de `bio load`, no solo de S. */
+    const KernelTrie* kernel; /**< Rutinas especializadas para m (NULL: camino genérico). */
 } Trie;
 
 #endif // BIO_STRUCT_H
\ No newline at end of file
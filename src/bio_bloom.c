@@ -0,0 +1,65 @@
+/**
+ * @file bio_bloom.c
+ * @brief Implementación del filtro de Bloom usado en el modo de solo conteo.
+ *
+ * Cada gen se resume en un hash de 64 bits y las BLOOM_HASHES posiciones se
+ * derivan por doble hashing (h1 + i·h2), evitando calcular varios hashes
+ * independientes por gen.
+ */
+
+#include <stdlib.h>
+
+#include "bio_bloom.h"
+
+FiltroBloom* crear_bloom(size_t elementos) {
+    FiltroBloom* filtro = malloc(sizeof(FiltroBloom));
+    if (!filtro) return NULL;
+    if (elementos == 0) elementos = 1;
+    filtro->num_bits = elementos * BLOOM_BITS_POR_ELEMENTO;
+    filtro->bits = calloc((filtro->num_bits + 63) / 64, sizeof(uint64_t));
+    if (!filtro->bits) {
+        free(filtro);
+        return NULL;
+    }
+    return filtro;
+}
+
+void liberar_bloom(FiltroBloom* filtro) {
+    if (!filtro) return;
+    free(filtro->bits);
+    free(filtro);
+}
+
+/**
+ * @brief Hash de 64 bits de un gen: acumula 2 bits por base y mezcla cada
+ *        32 bases con el finalizador de splitmix64.
+ */
+static uint64_t hash_gen(const uint8_t* codigos, int m) {
+    uint64_t h = 0x9E3779B97F4A7C15ULL ^ (uint64_t)m, bloque = 0;
+    for (int i = 0; i < m; i++) {
+        bloque = (bloque << 2) | codigos[i];
+        if ((i & 31) == 31 || i + 1 == m) {
+            h ^= bloque;
+            h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            h = (h ^ (h >> 27)) * 0x94D049BB133111EBULL;
+            h ^= h >> 31;
+            bloque = 0;
+        }
+    }
+    return h;
+}
+
+int bloom_visto(FiltroBloom* filtro, const uint8_t* codigos, int m) {
+    uint64_t h = hash_gen(codigos, m);
+    uint64_t h1 = h & 0xFFFFFFFFu, h2 = (h >> 32) | 1u;
+    int visto = 1;
+    for (int i = 0; i < BLOOM_HASHES; i++) {
+        size_t bit = (size_t)((h1 + (uint64_t)i * h2) % filtro->num_bits);
+        uint64_t marca = 1ULL << (bit % 64);
+        if (!(filtro->bits[bit / 64] & marca)) {
+            visto = 0;
+            filtro->bits[bit / 64] |= marca;
+        }
+    }
+    return visto;
+}
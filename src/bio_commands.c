@@ -27,51 +27,89 @@
 
 #include "bio_commands.h"
 #include "bio_func.h"
+#include "bio_simd.h"
+#include "bio_fm.h"
+#include "bio_server.h"
+#include "bio_externo.h"
+
+#ifdef BIO_TIEMPOS
+#include <time.h>
+
+/**
+ * @brief Milisegundos de un reloj de pared; solo con `make TIEMPOS=1`.
+ */
+static double reloj_ms(void) {
+    struct timespec t;
+    timespec_get(&t, TIME_UTC);
+    return (double)t.tv_sec * 1e3 + (double)t.tv_nsec / 1e6;
+}
+#endif
 
 /* ------------------------------------------------------------------------- */
 /* ---------------------- Declaraciones de funciones internas -------------- */
 /* ------------------------------------------------------------------------- */
 
 /**
- * @brief Verifica si un gen contiene exclusivamente caracteres A, C, G o T,
- *        y si su longitud coincide exactamente con m.
+ * @brief Normaliza un gen a mayúsculas y lo convierte a códigos 0..3,
+ *        verificando que tenga exactamente m bases A, C, G o T.
  *
- * @param s Cadena a validar.
- * @param m Tamaño esperado del gen.
+ * @param s       Cadena a validar.
+ * @param m       Tamaño esperado del gen.
+ * @param codigos Arreglo de m bytes donde se dejan los códigos.
  * @return 1 si es válido, 0 si no lo es.
  */
-static int  validar_gen(const char* s, int m);
+static int  codificar_gen(const char* s, int m, uint8_t* codigos);
 
 /**
- * @brief Navega el Trie siguiendo la secuencia s y retorna la hoja asociada.
+ * @brief Navega el Trie siguiendo los códigos de un gen y retorna la hoja asociada.
  *
- * @param trie Árbol Trie ya inicializado.
- * @param s    Cadena de longitud m.
+ * @param trie    Árbol Trie ya inicializado.
+ * @param codigos Arreglo de m códigos válidos.
  * @return Nodo hoja correspondiente, o NULL si el camino no existe.
  */
-static Nodo* navegar(Trie* trie, const char* s);
+static Nodo* navegar(Trie* trie, const uint8_t* codigos);
+
+/**
+ * @brief Busca un gen de cualquier largo en el FM-index e imprime sus posiciones.
+ *
+ * @param fm      FM-index de la secuencia S.
+ * @param codigos Gen convertido a códigos 0..3.
+ * @param largo   Cantidad de bases del gen.
+ * @param out     Flujo de salida.
+ */
+static void buscar_con_fm(const IndiceFM* fm, const uint8_t* codigos, int largo, FILE* out);
 
 /**
  * @brief Imprime todas las posiciones registradas en un nodo hoja.
  *
  * @param n Nodo hoja cuyo arreglo de posiciones se desea imprimir.
  */
-static void imprimir_posiciones(const Nodo* n);
+static void imprimir_posiciones(const Nodo* n, FILE* out);
+
+/**
+ * @brief Indica si el Trie quedó sin genes por haberse leído S en modo `sa`.
+ *
+ * En ese caso imprime un mensaje que explica que solo `bio search` (con el
+ * FM-index) tiene datos.
+ *
+ * @return 1 si no hay árbol que recorrer, 0 en caso contrario.
+ */
+static int  sin_arbol(const Trie* trie, FILE* out);
 
 /**
  * @brief Recorre el Trie e imprime todos los genes presentes.
  */
-void bio_all(Trie* trie);
+void bio_all(Trie* trie, FILE* out);
 
 /**
  * @brief Imprime los genes con mayor frecuencia de aparición.
  */
-void bio_max(Trie* trie);
+void bio_max(Trie* trie, FILE* out);
 
 /**
  * @brief Imprime los genes con menor frecuencia (>0) de aparición.
  */
-void bio_min(Trie* trie);
+void bio_min(Trie* trie, FILE* out);
 
 
 /* ------------------------------------------------------------------------- */
@@ -85,24 +123,86 @@ void mostrar_bienvenida() {
     printf("=========================================\n");
 }
 
-void leer_comando(Comando *c) {
+void parsear_comando(const char* linea, Comando *c) {
+    /* Limpiar estructura */
+    c->cmd[0] = c->arg1[0] = c->arg2[0] = c->arg3[0] = c->arg4[0] = '\0';
+    c->truncado = 0;
+    if (!linea) return;
+
+    /* Extraer hasta 5 componentes: cmd, subcomando y tres argumentos */
+    char* campos[5] = { c->cmd, c->arg1, c->arg2, c->arg3, c->arg4 };
+    size_t tamanos[5] = { sizeof(c->cmd), MAX_ARG, MAX_ARG, MAX_ARG, MAX_ARG };
+    const char* p = linea;
+    for (int i = 0; i < 5; i++) {
+        p += strspn(p, " \t");
+        size_t largo = strcspn(p, " \t");
+        if (largo == 0) return;
+        if (largo >= tamanos[i]) { c->truncado = 1; largo = tamanos[i] - 1; }
+        memcpy(campos[i], p, largo);
+        campos[i][largo] = '\0';
+        p += strcspn(p, " \t");
+    }
+    /* Un sexto componente no tiene dónde guardarse */
+    if (p[strspn(p, " \t")] != '\0') c->truncado = 1;
+}
+
+void informar_truncado(FILE* out) {
+    fprintf(out, "Comando demasiado largo o con demasiados argumentos: cada argumento admite hasta %d caracteres y la linea %d.\n",
+            MAX_ARG - 1, MAX_CMD - 2);
+}
+
+int leer_comando(Comando *c) {
     char buffer[MAX_CMD];
     printf("> ");
+    fflush(stdout);
     if (!fgets(buffer, sizeof(buffer), stdin)) {
-        c->cmd[0] = c->arg1[0] = c->arg2[0] = '\0';
-        return;
+        c->cmd[0] = c->arg1[0] = c->arg2[0] = c->arg3[0] = c->arg4[0] = '\0';
+        return 0;
+    }
+    /* Sin salto de línea y sin fin de archivo: la línea no cabía */
+    int recortada = !strchr(buffer, '\n') && !feof(stdin);
+    if (recortada) {
+        int ch;
+        while ((ch = getchar()) != EOF && ch != '\n') {}
     }
     /* Remover salto de línea */
-    buffer[strcspn(buffer, "\n")] = '\0';
+    buffer[strcspn(buffer, "\r\n")] = '\0';
 
-    /* Limpiar estructura */
-    c->cmd[0] = c->arg1[0] = c->arg2[0] = '\0';
+    parsear_comando(buffer, c);
+    if (recortada) c->truncado = 1;
+    return 1;
+}
 
-    /* Extraer hasta 3 componentes: cmd, subcomando, argumento */
-    sscanf(buffer, "%15s %63s %63s", c->cmd, c->arg1, c->arg2);
+int ejecutar_consulta(Comando *c, Trie* trie, FILE* out) {
+    if (strcmp(c->arg1, "search") == 0) {
+#ifdef BIO_TIEMPOS
+        double inicio = reloj_ms();
+        bio_search(trie, c->arg2, out);
+        fprintf(stderr, "Search time: %.3f us\n", (reloj_ms() - inicio) * 1e3);
+#else
+        bio_search(trie, c->arg2, out);
+#endif
+    } else if (strcmp(c->arg1, "prefix") == 0) {
+        bio_prefix(trie, c->arg2, out);
+    } else if (strcmp(c->arg1, "extract") == 0) {
+        bio_extract(trie, c->arg2, c->arg3, out);
+    } else if (strcmp(c->arg1, "max") == 0) {
+        bio_max(trie, out);
+    } else if (strcmp(c->arg1, "min") == 0) {
+        bio_min(trie, out);
+    } else if (strcmp(c->arg1, "all") == 0) {
+        bio_all(trie, out);
+    } else {
+        return 0;
+    }
+    return 1;
 }
 
 int ejecutar_comando(Comando *c, Trie** trie) {
+    if (c->truncado) {
+        informar_truncado(stdout);
+        return 1;
+    }
     if (strcmp(c->cmd, "bio") != 0) {
         printf("Comando no reconocido. Use 'bio <accion>'.\n");
         return 1;
@@ -110,17 +210,19 @@ int ejecutar_comando(Comando *c, Trie** trie) {
 
     /* Despacho de subcomandos */
     if (strcmp(c->arg1, "start") == 0) {
-        bio_start(c->arg2, trie);
+        bio_start(c->arg2, c->arg3, c->arg4, trie);
     } else if (strcmp(c->arg1, "read") == 0) {
-        bio_read(c->arg2, *trie);
-    } else if (strcmp(c->arg1, "search") == 0) {
-        bio_search(*trie, c->arg2);
-    } else if (strcmp(c->arg1, "max") == 0) {
-        bio_max(*trie);
-    } else if (strcmp(c->arg1, "min") == 0) {
-        bio_min(*trie);
-    } else if (strcmp(c->arg1, "all") == 0) {
-        bio_all(*trie);
+        bio_read(c->arg2, c->arg3, *trie);
+    } else if (strcmp(c->arg1, "build") == 0) {
+        bio_build(c->arg2, c->arg3, c->arg4, *trie);
+    } else if (strcmp(c->arg1, "load") == 0) {
+        bio_load(c->arg2, *trie);
+    } else if (ejecutar_consulta(c, *trie, stdout)) {
+        /* search, prefix, max, min y all ya fueron atendidos */
+    } else if (strcmp(c->arg1, "compare") == 0) {
+        bio_compare(c->arg2, c->arg3, c->arg4, *trie);
+    } else if (strcmp(c->arg1, "serve") == 0) {
+        bio_serve(c->arg2, trie);
     } else if (strcmp(c->arg1, "exit") == 0) {
         printf("Clearing cache and exiting…\n"); 
         return 0;
@@ -137,7 +239,8 @@ void ejecutar_cli() {
     mostrar_bienvenida();
 
     while (1) {
-        leer_comando(&c);
+        /* Fin de la entrada estándar: se trata igual que `bio exit` */
+        if (!leer_comando(&c)) break;
         if (ejecutar_comando(&c, &trie) == 0) break;
     }
     liberar_trie(trie);
@@ -148,7 +251,7 @@ void ejecutar_cli() {
 /* ------------------------- START / READ (I/O + carga) -------------------- */
 /* ------------------------------------------------------------------------- */
 
-void bio_start(const char* profundidad_str, Trie** trie) {
+void bio_start(const char* profundidad_str, const char* opcion, const char* filtro, Trie** trie) {
     if (*trie != NULL) {
         printf("El trie ya ha sido inicializado. Reinicie para cambiar la profundidad.\n");
         return;
@@ -157,48 +260,135 @@ void bio_start(const char* profundidad_str, Trie** trie) {
         printf("Profundidad invalida. Debe ser un numero entero positivo.\n");
         return;
     }
+    int m = atoi(profundidad_str);
+    int solo_conteo = (opcion && strcmp(opcion, "--count-only") == 0);
+    int con_filtro = (filtro && strcmp(filtro, "bloom") == 0);
+    if ((opcion && opcion[0] != '\0' && !solo_conteo) ||
+        (filtro && filtro[0] != '\0' && !(solo_conteo && con_filtro))) {
+        printf("Uso: bio start <m> [--count-only [bloom]]\n");
+        return;
+    }
+
+    /* Informar la estimación antes de reservar memoria */
+    printf("Memory estimate: about %.1f MB for %d bases with m=%d\n",
+           estimar_memoria_trie(m, MAX_SECUENCIA, solo_conteo) / (1024.0 * 1024.0), MAX_SECUENCIA, m);
+
     *trie = (Trie*)malloc(sizeof(Trie));
     if (*trie == NULL) {
         printf("Error al asignar memoria para el trie.\n");
         return;
     }
-    inicializar_trie(*trie, atoi(profundidad_str));
+    if (inicializar_trie(*trie, m) != 0) {
+        printf("Error al asignar memoria para el trie.\n");
+        free(*trie);
+        *trie = NULL;
+        return;
+    }
+    if (solo_conteo && activar_conteo(*trie, con_filtro) != 0) {
+        printf("Error al asignar memoria para el filtro de Bloom.\n");
+        liberar_trie(*trie);
+        *trie = NULL;
+        return;
+    }
     printf("Tree created with height %d\n", (*trie)->profundidad);
+    if (solo_conteo)
+        printf("Count-only mode%s\n", con_filtro ? " with Bloom filter (genes are indexed from their second occurrence)" : "");
 }
 
-void bio_read(const char* filename, Trie* trie) {
+void bio_read(const char* filename, const char* opcion, Trie* trie) {
     if (!trie || !trie->raiz) { printf("El trie no ha sido inicializado...\n"); return; }
-    FILE* file = fopen(filename, "r");
-    if (!file) { printf("No se pudo abrir: %s\n", filename); return; }
+    int con_fm = (opcion && strcmp(opcion, "sa") == 0);
+    if (opcion && opcion[0] != '\0' && !con_fm) {
+        printf("Opcion '%s' no reconocida. Use 'bio read <archivo> [sa]'.\n", opcion);
+        return;
+    }
+#ifdef BIO_TIEMPOS
+    double inicio = reloj_ms();
+#endif
+    /* Con 'sa' las búsquedas usan el FM-index, por lo que el árbol no se construye */
+    int estado = con_fm ? leer_secuencia(trie, filename) : cargar_secuencia(trie, filename);
+#ifdef BIO_TIEMPOS
+    fprintf(stderr, "Ingest time: %.3f ms\n", reloj_ms() - inicio);
+#endif
+    switch (estado) {
+        case CARGA_OK:
+            printf("Sequence S read from file\n");
+            if (con_fm) {
+                if (construir_indice_fm(trie) == CARGA_OK)
+                    printf("Suffix array built for %zu bases (tree not built)\n", trie->largo);
+                else
+                    printf("Error al asignar memoria para el arreglo de sufijos.\n");
+            }
+            break;
+        case CARGA_ERROR_ARCHIVO:
+            printf("No se pudo abrir: %s\n", filename);
+            break;
+        case CARGA_ERROR_LARGO:
+            printf("La secuencia es mas corta que m.\n");
+            break;
+        default:
+            printf("Error al asignar memoria para la secuencia.\n");
+            break;
+    }
+}
 
-    int m = trie->profundidad;
-    static const size_t MAX = 100000;
-    char *secuencia = malloc(MAX + 1);
-    if (!secuencia) { fclose(file); return; }
-    size_t len = 0;
-
-    int ch;
-    /* Leer archivo y normalizar a mayúsculas */
-    while ((ch = fgetc(file)) != EOF) {
-        if (ch == '\n' || ch == '\r') continue;
-        if (len < MAX) secuencia[len++] = (char)toupper((unsigned char)ch);
-        else break;
-    }
-    fclose(file);
-    if (len < (size_t)m) { printf("La secuencia es mas corta que m.\n"); free(secuencia); return; }
-    secuencia[len] = '\0';
-
-    /* Ventana deslizante tamaño m */
-    for (size_t i = 0; i + m <= len; i++) {
-        char *gen = malloc((size_t)m + 1);
-        if (!gen) break;
-        memcpy(gen, &secuencia[i], (size_t)m);
-        gen[m] = '\0';
-        insertar_en_trie(trie, gen, (int)i);
-        free(gen);
-    }
-    free(secuencia);
-    printf("Sequence S read from file\n");
+
+void bio_build(const char* filename, const char* opcion, const char* limite_str, Trie* trie) {
+    if (!trie || !trie->raiz) { printf("El trie no ha sido inicializado...\n"); return; }
+    if (!filename || filename[0] == '\0' || strcmp(opcion, "--mem-limit") != 0 || atoi(limite_str) <= 0) {
+        printf("Uso: bio build <archivo> --mem-limit <MB>\n");
+        return;
+    }
+    if (trie->profundidad > EXTERNO_MAX_M) {
+        printf("La construccion externa admite m hasta %d.\n", EXTERNO_MAX_M);
+        return;
+    }
+
+    char salida[MAX_ARG + 8];
+    snprintf(salida, sizeof(salida), "%s.idx", filename);
+    size_t limite = (size_t)atoi(limite_str) * 1024 * 1024;
+    ResumenExterno r;
+    switch (construir_indice_externo(filename, salida, trie->profundidad, limite, &r)) {
+        case CARGA_OK:
+            printf("Index written to %s\n", salida);
+            printf("%zu bases, %zu distinct genes, %d buckets in %d passes (largest %.1f MB, %d sorted on disk)\n",
+                   r.bases, r.genes, r.cubetas, r.pasadas, r.mayor_cubeta / (1024.0 * 1024.0), r.en_disco);
+            break;
+        case CARGA_ERROR_ARCHIVO:
+            printf("No se pudo abrir: %s\n", filename);
+            break;
+        case CARGA_ERROR_LARGO:
+            printf("La secuencia es mas corta que m.\n");
+            break;
+        case CARGA_ERROR_TAMANO:
+            printf("El archivo supera el maximo de %ld bytes: las posiciones se guardan como int. Divida la secuencia (por ejemplo, por cromosoma).\n",
+                   EXTERNO_MAX_BYTES);
+            break;
+        case CARGA_ERROR_ESCRITURA:
+            printf("No se pudo escribir el indice: %s\n", salida);
+            break;
+        default:
+            printf("Error al asignar memoria para ordenar una cubeta.\n");
+            break;
+    }
+}
+
+void bio_load(const char* filename, Trie* trie) {
+    if (!trie || !trie->raiz) { printf("El trie no ha sido inicializado...\n"); return; }
+    switch (cargar_indice(trie, filename)) {
+        case CARGA_OK:
+            printf("Index loaded from file\n");
+            break;
+        case CARGA_ERROR_ARCHIVO:
+            printf("No se pudo abrir: %s\n", filename);
+            break;
+        case CARGA_ERROR_FORMATO:
+            printf("Archivo de indice invalido o con m distinta: %s\n", filename);
+            break;
+        default:
+            printf("Error al asignar memoria para el indice.\n");
+            break;
+    }
 }
 
 
@@ -206,32 +396,56 @@ void bio_read(const char* filename, Trie* trie) {
 /* ----------------------- Helpers: búsqueda / impresión -------------------- */
 /* ------------------------------------------------------------------------- */
 
-static int validar_gen(const char* s, int m) {
-    if (!s) return 0;
-    for (int i = 0; i < m; i++) {
-        char c = s[i];
-        if (c == '\0') return 0;
-        if (!(c == 'A' || c == 'C' || c == 'G' || c == 'T')) return 0;
-    }
-    return s[m] == '\0';
+static int codificar_gen(const char* s, int m, uint8_t* codigos) {
+    if (!s || (int)strlen(s) != m) return 0;
+    char *buf = malloc((size_t)m);
+    if (!buf) return 0;
+    /* Normalizar a mayúsculas y validar con las rutinas vectorizadas */
+    normalizar_bases(buf, s, (size_t)m);
+    size_t invalidos = codificar_bases(codigos, buf, (size_t)m);
+    free(buf);
+    return invalidos == 0;
 }
 
-static Nodo* navegar(Trie* trie, const char* s) {
+static Nodo* navegar(Trie* trie, const uint8_t* codigos) {
+    if (trie->kernel) return trie->kernel->buscar(trie, codigos);
     Nodo* act = trie->raiz;
     for (int i = 0; i < trie->profundidad; i++) {
-        int idx = char_a_indice(s[i]);
-        if (idx < 0 || !act->hijos[idx]) return NULL;
-        act = act->hijos[idx];
+        act = act->hijos[codigos[i]];
+        if (!act) return NULL;
     }
     return act;
 }
 
-static void imprimir_posiciones(const Nodo* n) {
+static void buscar_con_fm(const IndiceFM* fm, const uint8_t* codigos, int largo, FILE* out) {
+    int* posiciones;
+    int cantidad = buscar_fm(fm, codigos, largo, &posiciones);
+    if (cantidad <= 0) { fprintf(out, "-1\n"); return; }
+    for (int i = 0; i < cantidad; i++) {
+        fprintf(out, "%d", posiciones[i]);
+        if (i + 1 < cantidad) fputc(' ', out);
+    }
+    fputc('\n', out);
+    free(posiciones);
+}
+
+static int sin_arbol(const Trie* trie, FILE* out) {
+    if (!trie->fm || trie->distintos > 0) return 0;
+    fprintf(out, "El arbol esta vacio: 'bio read <archivo> sa' solo construye el arreglo de sufijos. Use 'bio search' o lea el archivo sin 'sa'.\n");
+    return 1;
+}
+
+static void imprimir_posiciones(const Nodo* n, FILE* out) {
+    /* Hoja del modo de solo conteo: no hay posiciones que listar */
+    if (!n->posiciones) {
+        fprintf(out, "count=%d\n", n->numPosiciones);
+        return;
+    }
     for (int i = 0; i < n->numPosiciones; i++) {
-        printf("%d", n->posiciones[i]);
-        if (i + 1 < n->numPosiciones) printf(" ");
+        fprintf(out, "%d", n->posiciones[i]);
+        if (i + 1 < n->numPosiciones) fputc(' ', out);
     }
-    printf("\n");
+    fputc('\n', out);
 }
 
 
@@ -239,34 +453,81 @@ static void imprimir_posiciones(const Nodo* n) {
 /* ------------------------------ SEARCH ----------------------------------- */
 /* ------------------------------------------------------------------------- */
 
-void bio_search(Trie* trie, const char* secuencia) {
-    if (!trie || !trie->raiz || !secuencia) { printf("-1\n"); return; }
+void bio_search(Trie* trie, const char* secuencia, FILE* out) {
+    if (!trie || !trie->raiz || !secuencia) { fprintf(out, "-1\n"); return; }
     int m = trie->profundidad;
-    char *buf = malloc((size_t)m + 1);
-    if (!buf) { printf("-1\n"); return; }
-    /* Normalizar entrada a mayúsculas */
-    for (int i = 0; i < m && secuencia[i]; i++)
-        buf[i] = (char)toupper((unsigned char)secuencia[i]);
-
-    if ((int)strlen(secuencia) != m) {
-        free(buf);
-        printf("-1\n");
+    int largo = (int)strlen(secuencia);
+    /* Sin FM-index solo se aceptan genes de largo m o mayores verificables contra S */
+    if (largo == 0 || (!trie->fm && (largo < m || (largo > m && (!trie->secuencia || trie->solo_conteo))))) {
+        fprintf(out, "-1\n");
+        return;
+    }
+    if (!trie->fm && largo > m && trie->fuentes_mixtas) {
+        fprintf(out, "No se pueden buscar genes mas largos que m: el arbol tiene posiciones de varias lecturas o de un indice cargado.\n");
+        return;
+    }
+
+    uint8_t *codigos = malloc((size_t)largo);
+    if (!codigos) { fprintf(out, "-1\n"); return; }
+    if (!codificar_gen(secuencia, largo, codigos)) {
+        free(codigos);
+        fprintf(out, "-1\n");
         return;
     }
-    buf[m] = '\0';
-    if (!validar_gen(buf, m)) {
-        free(buf);
-        printf("-1\n");
+    if (trie->fm) {
+        buscar_con_fm(trie->fm, codigos, largo, out);
+        free(codigos);
         return;
     }
-    Nodo* hoja = navegar(trie, buf);
+    Nodo* hoja = navegar(trie, codigos);
     if (!hoja || hoja->numPosiciones == 0) {
-        free(buf);
-        printf("-1\n");
+        free(codigos);
+        fprintf(out, "-1\n");
         return;
     }
-    imprimir_posiciones(hoja);
-    free(buf);
+    if (largo == m) {
+        imprimir_posiciones(hoja, out);
+        free(codigos);
+        return;
+    }
+
+    /* Extender cada aparición de las primeras m bases contra S */
+    int encontrados = 0;
+    for (int i = 0; i < hoja->numPosiciones; i++) {
+        size_t p = (size_t)hoja->posiciones[i];
+        if (p + (size_t)largo > trie->largo) continue;
+        int k = m;
+        while (k < largo && base_en(trie, p + (size_t)k) == codigos[k]) k++;
+        if (k < largo) continue;
+        if (encontrados++ > 0) fputc(' ', out);
+        fprintf(out, "%zu", p);
+    }
+    fprintf(out, encontrados ? "\n" : "-1\n");
+    free(codigos);
+}
+
+
+/* ------------------------------------------------------------------------- */
+/* ------------------------------ EXTRACT ---------------------------------- */
+/* ------------------------------------------------------------------------- */
+
+void bio_extract(Trie* trie, const char* pos_str, const char* largo_str, FILE* out) {
+    if (!trie || !trie->secuencia || !pos_str || !largo_str) { fprintf(out, "-1\n"); return; }
+    char *fin1, *fin2;
+    long pos = strtol(pos_str, &fin1, 10);
+    long largo = strtol(largo_str, &fin2, 10);
+    if (*pos_str == '\0' || *fin1 != '\0' || *largo_str == '\0' || *fin2 != '\0' ||
+        pos < 0 || largo <= 0 || (size_t)pos >= trie->largo) {
+        fprintf(out, "-1\n");
+        return;
+    }
+
+    static const char L[5] = {'A','C','G','T','N'};
+    size_t fin = (size_t)pos + (size_t)largo;
+    if (fin > trie->largo) fin = trie->largo;
+    for (size_t i = (size_t)pos; i < fin; i++)
+        fputc(L[base_en(trie, i)], out);
+    fputc('\n', out);
 }
 
 
@@ -274,29 +535,29 @@ void bio_search(Trie* trie, const char* secuencia) {
 /* ------------------------------- ALL ------------------------------------- */
 /* ------------------------------------------------------------------------- */
 
-static void dfs_all(Nodo* nodo, char* pref, int depth, int m) {
+static void dfs_all(Nodo* nodo, char* pref, int depth, int m, FILE* out) {
     if (!nodo) return;
     if (depth == m) {
         if (nodo->numPosiciones > 0) {
             pref[m] = '\0';
-            printf("%s ", pref);
-            imprimir_posiciones(nodo);
+            fprintf(out, "%s ", pref);
+            imprimir_posiciones(nodo, out);
         }
         return;
     }
     static const char L[4] = {'A','C','G','T'};
     for (int i = 0; i < 4; i++) {
         pref[depth] = L[i];
-        dfs_all(nodo->hijos[i], pref, depth + 1, m);
+        dfs_all(nodo->hijos[i], pref, depth + 1, m, out);
     }
 }
 
-void bio_all(Trie* trie) {
-    if (!trie || !trie->raiz) return;
+void bio_all(Trie* trie, FILE* out) {
+    if (!trie || !trie->raiz || sin_arbol(trie, out)) return;
     int m = trie->profundidad;
     char *pref = malloc((size_t)m + 1);
     if (!pref) return;
-    dfs_all(trie->raiz, pref, 0, m);
+    dfs_all(trie->raiz, pref, 0, m, out);
     free(pref);
 }
 
@@ -317,41 +578,168 @@ static void dfs_freq(Nodo* nodo, int depth, int m, int* maxf, int* minf) {
     for (int i = 0; i < 4; i++) dfs_freq(nodo->hijos[i], depth + 1, m, maxf, minf);
 }
 
-static void dfs_print_by_freq(Nodo* nodo, char* pref, int depth, int m, int target) {
+static void dfs_print_by_freq(Nodo* nodo, char* pref, int depth, int m, int target, FILE* out) {
     if (!nodo) return;
     if (depth == m) {
         if (nodo->numPosiciones == target && target > 0) {
             pref[m] = '\0';
-            printf("%s ", pref);
-            imprimir_posiciones(nodo);
+            fprintf(out, "%s ", pref);
+            imprimir_posiciones(nodo, out);
         }
         return;
     }
     static const char L[4] = {'A','C','G','T'};
     for (int i = 0; i < 4; i++) {
         pref[depth] = L[i];
-        dfs_print_by_freq(nodo->hijos[i], pref, depth + 1, m, target);
+        dfs_print_by_freq(nodo->hijos[i], pref, depth + 1, m, target, out);
     }
 }
 
-void bio_max(Trie* trie) {
-    if (!trie || !trie->raiz) { printf("-1\n"); return; }
+void bio_max(Trie* trie, FILE* out) {
+    if (!trie || !trie->raiz) { fprintf(out, "-1\n"); return; }
+    if (sin_arbol(trie, out)) return;
     int maxf = 0, minf = INT_MAX;
     dfs_freq(trie->raiz, 0, trie->profundidad, &maxf, &minf);
-    if (maxf <= 0) { printf("-1\n"); return; }
+    if (maxf <= 0) { fprintf(out, "-1\n"); return; }
     char *pref = malloc((size_t)trie->profundidad + 1);
     if (!pref) return;
-    dfs_print_by_freq(trie->raiz, pref, 0, trie->profundidad, maxf);
+    dfs_print_by_freq(trie->raiz, pref, 0, trie->profundidad, maxf, out);
     free(pref);
 }
 
-void bio_min(Trie* trie) {
-    if (!trie || !trie->raiz) { printf("-1\n"); return; }
+void bio_min(Trie* trie, FILE* out) {
+    if (!trie || !trie->raiz) { fprintf(out, "-1\n"); return; }
+    if (sin_arbol(trie, out)) return;
     int maxf = 0, minf = INT_MAX;
     dfs_freq(trie->raiz, 0, trie->profundidad, &maxf, &minf);
-    if (minf == INT_MAX) { printf("-1\n"); return; }
+    if (minf == INT_MAX) { fprintf(out, "-1\n"); return; }
     char *pref = malloc((size_t)trie->profundidad + 1);
     if (!pref) return;
-    dfs_print_by_freq(trie->raiz, pref, 0, trie->profundidad, minf);
+    dfs_print_by_freq(trie->raiz, pref, 0, trie->profundidad, minf, out);
+    free(pref);
+}
+
+
+/* ------------------------------------------------------------------------- */
+/* ------------------------------ PREFIX ----------------------------------- */
+/* ------------------------------------------------------------------------- */
+
+void bio_prefix(Trie* trie, const char* prefijo, FILE* out) {
+    if (!trie || !trie->raiz || !prefijo) { fprintf(out, "-1\n"); return; }
+    if (sin_arbol(trie, out)) return;
+    int m = trie->profundidad;
+    int largo = (int)strlen(prefijo);
+    if (largo == 0 || largo > m) { fprintf(out, "-1\n"); return; }
+
+    char *pref = malloc((size_t)m + 1);
+    if (!pref) { fprintf(out, "-1\n"); return; }
+
+    /* Normalizar y descender por el Trie hasta el final del prefijo */
+    Nodo* act = trie->raiz;
+    for (int i = 0; i < largo && act; i++) {
+        pref[i] = (char)toupper((unsigned char)prefijo[i]);
+        int idx = char_a_indice(pref[i]);
+        act = (idx < 0) ? NULL : act->hijos[idx];
+    }
+
+    int maxf = 0, minf = INT_MAX;
+    dfs_freq(act, largo, m, &maxf, &minf);
+    if (maxf <= 0) { fprintf(out, "-1\n"); free(pref); return; }
+    dfs_all(act, pref, largo, m, out);
+    free(pref);
+}
+
+
+/* ------------------------------------------------------------------------- */
+/* ------------------------------ COMPARE ---------------------------------- */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @brief Recorre dos Tries en paralelo contando (y opcionalmente listando)
+ *        los genes presentes en ambos.
+ *
+ * Un subárbol ausente en cualquiera de los dos lados se descarta sin
+ * recorrerlo, ya que no puede contener genes compartidos.
+ */
+static void dfs_comparar(Nodo* a, Nodo* b, char* pref, int depth, int m, size_t* compartidos, FILE* out) {
+    if (!a || !b) return;
+    if (depth == m) {
+        if (a->numPosiciones > 0 && b->numPosiciones > 0) {
+            (*compartidos)++;
+            if (out) {
+                pref[m] = '\0';
+                fprintf(out, "%s ", pref);
+                for (int i = 0; i < a->numPosiciones; i++) fprintf(out, "%d ", a->posiciones[i]);
+                fputc('|', out);
+                for (int i = 0; i < b->numPosiciones; i++) fprintf(out, " %d", b->posiciones[i]);
+                fputc('\n', out);
+            }
+        }
+        return;
+    }
+    static const char L[4] = {'A','C','G','T'};
+    for (int i = 0; i < 4; i++) {
+        pref[depth] = L[i];
+        dfs_comparar(a->hijos[i], b->hijos[i], pref, depth + 1, m, compartidos, out);
+    }
+}
+
+/**
+ * @brief Crea un Trie temporal de profundidad m y carga en él un archivo.
+ *
+ * @param solo_conteo 1 si no hacen falta las posiciones (solo se cuentan genes).
+ * @return El Trie cargado, o NULL si el archivo no pudo leerse.
+ */
+static Trie* cargar_temporal(const char* filename, int m, int solo_conteo) {
+    Trie* t = (Trie*)malloc(sizeof(Trie));
+    if (!t) { printf("Error al asignar memoria para el trie.\n"); return NULL; }
+    if (inicializar_trie(t, m) != 0) {
+        printf("Error al asignar memoria para el trie.\n");
+        free(t);
+        return NULL;
+    }
+    if (solo_conteo) activar_conteo(t, 0);
+    int estado = cargar_secuencia(t, filename);
+    if (estado == CARGA_OK) return t;
+
+    if (estado == CARGA_ERROR_ARCHIVO) printf("No se pudo abrir: %s\n", filename);
+    else if (estado == CARGA_ERROR_LARGO) printf("La secuencia de %s es mas corta que m.\n", filename);
+    else printf("Error al asignar memoria para la secuencia.\n");
+    liberar_trie(t);
+    return NULL;
+}
+
+void bio_compare(const char* archivo_a, const char* archivo_b, const char* opcion, Trie* trie) {
+    if (!trie || !trie->raiz) { printf("El trie no ha sido inicializado...\n"); return; }
+    if (!archivo_a || !archivo_b || archivo_a[0] == '\0' || archivo_b[0] == '\0') {
+        printf("Uso: bio compare <archivoA> <archivoB> [all]\n");
+        return;
+    }
+    int listar = (opcion && strcmp(opcion, "all") == 0);
+    if (opcion && opcion[0] != '\0' && !listar) {
+        printf("Opcion '%s' no reconocida. Use 'bio compare <archivoA> <archivoB> [all]'.\n", opcion);
+        return;
+    }
+
+    int m = trie->profundidad;
+    Trie* a = cargar_temporal(archivo_a, m, !listar);
+    if (!a) return;
+    Trie* b = cargar_temporal(archivo_b, m, !listar);
+    if (!b) { liberar_trie(a); return; }
+    char *pref = malloc((size_t)m + 1);
+    if (!pref) { liberar_trie(a); liberar_trie(b); return; }
+
+    size_t compartidos = 0;
+    dfs_comparar(a->raiz, b->raiz, pref, 0, m, &compartidos, listar ? stdout : NULL);
+
+    /* Los exclusivos se obtienen de la cantidad de genes distintos de cada lado */
+    size_t union_ab = a->distintos + b->distintos - compartidos;
+    printf("Shared: %zu\n", compartidos);
+    printf("Only in %s: %zu\n", archivo_a, a->distintos - compartidos);
+    printf("Only in %s: %zu\n", archivo_b, b->distintos - compartidos);
+    printf("Jaccard: %.6f\n", union_ab ? (double)compartidos / (double)union_ab : 0.0);
+
     free(pref);
+    liberar_trie(a);
+    liberar_trie(b);
 }
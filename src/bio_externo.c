@@ -0,0 +1,490 @@
+/**
+ * @file bio_externo.c
+ * @brief Implementación de la construcción del índice en memoria externa
+ *        y de la carga del archivo de índice.
+ *
+ * Este archivo contiene:
+ * - La elección de la cantidad de bases de prefijo según el límite de memoria.
+ * - El reparto de los genes del archivo en cubetas temporales en disco.
+ * - El ordenamiento de cada cubeta (en memoria o, si excede el límite, por
+ *   intercalación de corridas en disco) y su escritura agrupada por gen.
+ * - La lectura del índice resultante hacia un Trie.
+ *
+ * Los genes se codifican como enteros de 64 bits (2 bits por base, la
+ * primera base en los bits más significativos), por lo que el orden numérico
+ * coincide con el orden alfabético A < C < G < T utilizado por el Trie.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+#include "bio_externo.h"
+#include "bio_func.h"
+#include "bio_simd.h"
+
+/**
+ * @brief Bytes leídos del archivo de entrada en cada bloque.
+ */
+#define BLOQUE_LECTURA (1 << 20)
+
+/**
+ * @brief Máximo de bases de prefijo usadas para repartir: 4^4 cubetas, las
+ *        que caben en una pasada (EXTERNO_MAX_CUBETAS). Las cubetas que aun
+ *        así exceden el límite se ordenan en disco.
+ */
+#define MAX_PREFIJO 4
+
+/**
+ * @brief Corridas que se intercalan a la vez al ordenar una cubeta en disco.
+ */
+#define FUSION_MAX 16
+
+/**
+ * @brief Aparición de un gen tal como se guarda en una cubeta temporal.
+ */
+typedef struct {
+    uint64_t codigo;    /**< Gen codificado a 2 bits por base. */
+    uint32_t posicion;  /**< Posición de inicio dentro de S. */
+    uint32_t relleno;   /**< Sin uso; mantiene el registro alineado a 16 bytes. */
+} Registro;
+
+/* ------------------------------------------------------------------------- */
+/* ------------------------------ REPARTO ---------------------------------- */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @brief Elige cuántas bases de prefijo usar para que cada cubeta quepa
+ *        (en promedio) dentro del límite de memoria.
+ *
+ * El archivo tiene a lo sumo tantos genes como bytes, y cada base adicional
+ * de prefijo divide por 4 el tamaño esperado de cada cubeta. Con a lo sumo
+ * MAX_PREFIJO bases el archivo se recorre una sola vez.
+ */
+static int elegir_prefijo(int m, size_t bytes_archivo, size_t limite) {
+    double por_cubeta = (double)bytes_archivo * sizeof(Registro);
+    int b = 0;
+    while (b < m && b < MAX_PREFIJO && por_cubeta > (double)limite) {
+        por_cubeta /= 4.0;
+        b++;
+    }
+    return b;
+}
+
+/**
+ * @brief Recorre el archivo de entrada y escribe en disco las apariciones de
+ *        los genes cuyo prefijo corresponde a las cubetas [primera, primera + n).
+ *
+ * @param bases Recibe la cantidad de bases (sin saltos de línea) del archivo.
+ */
+static int repartir(const char* archivo, int m, int b, int primera, int n,
+                    FILE** cubetas, size_t* bases) {
+    FILE* f = fopen(archivo, "rb");
+    if (!f) return CARGA_ERROR_ARCHIVO;
+    char* bloque = malloc(BLOQUE_LECTURA);
+    uint8_t* codigos = malloc(BLOQUE_LECTURA);
+    if (!bloque || !codigos) {
+        free(bloque); free(codigos); fclose(f);
+        return CARGA_ERROR_MEMORIA;
+    }
+
+    const uint64_t mascara = (m == 32) ? UINT64_MAX : ((1ULL << (2 * m)) - 1);
+    const int corrimiento = 2 * (m - b);
+    uint64_t codigo = 0;
+    size_t racha = 0, pos = 0, leidos;
+    int estado = CARGA_OK;
+
+    while (estado == CARGA_OK && (leidos = fread(bloque, 1, BLOQUE_LECTURA, f)) > 0) {
+        size_t k = normalizar_bases(bloque, bloque, leidos);
+        codificar_bases(codigos, bloque, k);
+        for (size_t i = 0; i < k; i++, pos++) {
+            if (codigos[i] == BASE_INVALIDA) { racha = 0; continue; }
+            codigo = ((codigo << 2) | codigos[i]) & mascara;
+            if (++racha < (size_t)m) continue;
+
+            size_t inicio = pos + 1 - (size_t)m;
+            /* Solo si el archivo creció después de validar su tamaño */
+            if (inicio > INT_MAX) { estado = CARGA_ERROR_TAMANO; break; }
+            int cubeta = (b == 0) ? 0 : (int)(codigo >> corrimiento);
+            if (cubeta < primera || cubeta >= primera + n) continue;
+
+            Registro r = { codigo, (uint32_t)inicio, 0 };
+            if (fwrite(&r, sizeof(r), 1, cubetas[cubeta - primera]) != 1) {
+                estado = CARGA_ERROR_ESCRITURA;
+                break;
+            }
+        }
+    }
+    free(bloque);
+    free(codigos);
+    fclose(f);
+    *bases = pos;
+    return estado;
+}
+
+/* ------------------------------------------------------------------------- */
+/* ------------------------- ORDENAR Y ESCRIBIR ---------------------------- */
+/* ------------------------------------------------------------------------- */
+
+static int comparar_registros(const void* a, const void* b) {
+    const Registro* x = (const Registro*)a;
+    const Registro* y = (const Registro*)b;
+    if (x->codigo != y->codigo) return (x->codigo > y->codigo) - (x->codigo < y->codigo);
+    return (x->posicion > y->posicion) - (x->posicion < y->posicion);
+}
+
+/**
+ * @brief Escribe en el índice registros ya ordenados y en memoria,
+ *        agrupados por gen.
+ */
+static int escribir_grupos(const Registro* r, size_t n, FILE* salida, size_t* genes) {
+    for (size_t i = 0; i < n; ) {
+        size_t j = i;
+        while (j < n && r[j].codigo == r[i].codigo) j++;
+        uint32_t cantidad = (uint32_t)(j - i);
+        if (fwrite(&r[i].codigo, sizeof(uint64_t), 1, salida) != 1 ||
+            fwrite(&cantidad, sizeof(uint32_t), 1, salida) != 1)
+            return CARGA_ERROR_ESCRITURA;
+        for (size_t k = i; k < j; k++)
+            if (fwrite(&r[k].posicion, sizeof(uint32_t), 1, salida) != 1)
+                return CARGA_ERROR_ESCRITURA;
+        (*genes)++;
+        i = j;
+    }
+    return CARGA_OK;
+}
+
+/**
+ * @brief Escribe en el índice los registros de un archivo ya ordenado,
+ *        agrupados por gen, leyendo de a un registro.
+ *
+ * La cantidad de cada gen se conoce al terminar su grupo, por lo que se
+ * reserva su lugar y se completa después.
+ */
+static int escribir_grupos_disco(FILE* ordenada, FILE* salida, size_t* genes) {
+    Registro r;
+    rewind(ordenada);
+    int hay = fread(&r, sizeof(r), 1, ordenada) == 1;
+    while (hay) {
+        uint64_t codigo = r.codigo;
+        uint32_t cantidad = 0;
+        long inicio = ftell(salida);
+        if (inicio < 0 ||
+            fwrite(&codigo, sizeof(codigo), 1, salida) != 1 ||
+            fwrite(&cantidad, sizeof(cantidad), 1, salida) != 1)
+            return CARGA_ERROR_ESCRITURA;
+        while (hay && r.codigo == codigo) {
+            if (fwrite(&r.posicion, sizeof(uint32_t), 1, salida) != 1) return CARGA_ERROR_ESCRITURA;
+            cantidad++;
+            hay = fread(&r, sizeof(r), 1, ordenada) == 1;
+        }
+        long fin = ftell(salida);
+        if (fin < 0 ||
+            fseek(salida, inicio + (long)sizeof(uint64_t), SEEK_SET) != 0 ||
+            fwrite(&cantidad, sizeof(cantidad), 1, salida) != 1 ||
+            fseek(salida, fin, SEEK_SET) != 0)
+            return CARGA_ERROR_ESCRITURA;
+        (*genes)++;
+    }
+    return ferror(ordenada) ? CARGA_ERROR_ESCRITURA : CARGA_OK;
+}
+
+/**
+ * @brief Corrida ordenada dentro de un archivo temporal, leída por tramos.
+ */
+typedef struct {
+    size_t siguiente;  /**< Próximo registro del archivo aún no leído. */
+    size_t fin;        /**< Registro donde termina la corrida. */
+    Registro* buffer;  /**< Tramo leído en memoria. */
+    size_t cargados;   /**< Registros válidos en buffer. */
+    size_t actual;     /**< Registro de buffer que encabeza la corrida. */
+} Corrida;
+
+/**
+ * @brief Lee el siguiente tramo de una corrida agotada en memoria.
+ *
+ * @return 1 si hay registros, 0 si la corrida terminó, -1 si falló la lectura.
+ */
+static int recargar(Corrida* c, FILE* origen, size_t por_buffer) {
+    c->actual = c->cargados = 0;
+    if (c->siguiente >= c->fin) return 0;
+    size_t k = (c->fin - c->siguiente < por_buffer) ? c->fin - c->siguiente : por_buffer;
+    if (fseek(origen, (long)(c->siguiente * sizeof(Registro)), SEEK_SET) != 0 ||
+        fread(c->buffer, sizeof(Registro), k, origen) != k)
+        return -1;
+    c->siguiente += k;
+    c->cargados = k;
+    return 1;
+}
+
+/**
+ * @brief Intercala las corridas consecutivas [primera, primera + k) de
+ *        `largo` registros de `origen` y agrega el resultado a `destino`.
+ *
+ * Cada corrida se lee por tramos de `por_buffer` registros dentro de
+ * `memoria`, por lo que la intercalación no usa más que el límite.
+ */
+static int fusionar(FILE* origen, size_t n, size_t primera, size_t largo, size_t k,
+                    Registro* memoria, size_t por_buffer, FILE* destino) {
+    Corrida c[FUSION_MAX];
+    for (size_t i = 0; i < k; i++) {
+        c[i].siguiente = (primera + i) * largo;
+        c[i].fin = (c[i].siguiente + largo < n) ? c[i].siguiente + largo : n;
+        c[i].buffer = memoria + i * por_buffer;
+        if (recargar(&c[i], origen, por_buffer) < 0) return CARGA_ERROR_ESCRITURA;
+    }
+    while (1) {
+        size_t menor = k;
+        for (size_t i = 0; i < k; i++)
+            if (c[i].actual < c[i].cargados &&
+                (menor == k || comparar_registros(&c[i].buffer[c[i].actual],
+                                                  &c[menor].buffer[c[menor].actual]) < 0))
+                menor = i;
+        if (menor == k) return CARGA_OK;
+        if (fwrite(&c[menor].buffer[c[menor].actual], sizeof(Registro), 1, destino) != 1)
+            return CARGA_ERROR_ESCRITURA;
+        if (++c[menor].actual == c[menor].cargados &&
+            recargar(&c[menor], origen, por_buffer) < 0)
+            return CARGA_ERROR_ESCRITURA;
+    }
+}
+
+/**
+ * @brief Ordena en disco una cubeta que no cabe en el límite de memoria.
+ *
+ * Se escriben una tras otra, en un archivo temporal, corridas ordenadas de a
+ * lo sumo `limite` bytes; luego cada ronda intercala grupos de FUSION_MAX
+ * corridas consecutivas hacia un segundo archivo, hasta que queda una sola.
+ * Solo hay dos archivos temporales abiertos, sea cual sea el tamaño de la
+ * cubeta, y la memoria de la intercalación se reparte entre las corridas.
+ *
+ * @param ordenada Recibe el archivo temporal con los n registros ordenados.
+ */
+static int ordenar_en_disco(FILE* cubeta, size_t n, size_t limite, FILE** ordenada) {
+    size_t capacidad = limite / sizeof(Registro);
+    if (capacidad < FUSION_MAX) capacidad = FUSION_MAX;
+    Registro* r = malloc(capacidad * sizeof(Registro));
+    FILE* origen = tmpfile();
+    if (!r || !origen) {
+        free(r);
+        if (origen) fclose(origen);
+        return r ? CARGA_ERROR_ESCRITURA : CARGA_ERROR_MEMORIA;
+    }
+
+    int estado = CARGA_OK;
+    rewind(cubeta);
+    for (size_t hechos = 0; hechos < n && estado == CARGA_OK; hechos += capacidad) {
+        size_t k = (n - hechos < capacidad) ? n - hechos : capacidad;
+        if (fread(r, sizeof(Registro), k, cubeta) != k) { estado = CARGA_ERROR_ESCRITURA; break; }
+        qsort(r, k, sizeof(Registro), comparar_registros);
+        if (fwrite(r, sizeof(Registro), k, origen) != k) estado = CARGA_ERROR_ESCRITURA;
+    }
+
+    /* Cada ronda multiplica por FUSION_MAX el largo de las corridas */
+    size_t por_buffer = capacidad / FUSION_MAX;
+    for (size_t largo = capacidad; largo < n && estado == CARGA_OK; largo *= FUSION_MAX) {
+        FILE* destino = tmpfile();
+        if (!destino) { estado = CARGA_ERROR_ESCRITURA; break; }
+        size_t corridas = (n + largo - 1) / largo;
+        for (size_t i = 0; i < corridas && estado == CARGA_OK; i += FUSION_MAX) {
+            size_t k = (corridas - i < FUSION_MAX) ? corridas - i : FUSION_MAX;
+            estado = fusionar(origen, n, i, largo, k, r, por_buffer, destino);
+        }
+        fclose(origen);
+        origen = destino;
+    }
+    free(r);
+
+    if (estado != CARGA_OK) {
+        fclose(origen);
+        return estado;
+    }
+    *ordenada = origen;
+    return CARGA_OK;
+}
+
+/**
+ * @brief Ordena una cubeta y la agrega al índice agrupada por gen.
+ *
+ * Si la cubeta cabe en el límite se ordena en memoria; si no, en disco.
+ *
+ * @param genes       Se incrementa con los genes distintos escritos.
+ * @param mayor_bytes Se actualiza con el tamaño de la mayor cubeta vista.
+ * @param en_disco    Se incrementa si la cubeta tuvo que ordenarse en disco.
+ */
+static int volcar_cubeta(FILE* cubeta, FILE* salida, size_t limite,
+                         size_t* genes, size_t* mayor_bytes, int* en_disco) {
+    if (fflush(cubeta) != 0 || fseek(cubeta, 0, SEEK_END) != 0) return CARGA_ERROR_ESCRITURA;
+    long bytes = ftell(cubeta);
+    if (bytes <= 0) return CARGA_OK;
+    if ((size_t)bytes > *mayor_bytes) *mayor_bytes = (size_t)bytes;
+    size_t n = (size_t)bytes / sizeof(Registro);
+
+    if ((size_t)bytes > limite) {
+        FILE* ordenada;
+        int estado = ordenar_en_disco(cubeta, n, limite, &ordenada);
+        if (estado != CARGA_OK) return estado;
+        estado = escribir_grupos_disco(ordenada, salida, genes);
+        fclose(ordenada);
+        (*en_disco)++;
+        return estado;
+    }
+
+    Registro* r = malloc(n * sizeof(Registro));
+    if (!r) return CARGA_ERROR_MEMORIA;
+    rewind(cubeta);
+    if (fread(r, sizeof(Registro), n, cubeta) != n) { free(r); return CARGA_ERROR_ESCRITURA; }
+    qsort(r, n, sizeof(Registro), comparar_registros);
+    int estado = escribir_grupos(r, n, salida, genes);
+    free(r);
+    return estado;
+}
+
+static int escribir_cabecera(FILE* f, int m, uint64_t genes, uint64_t bases) {
+    char firma[8] = INDICE_FIRMA;
+    uint32_t profundidad = (uint32_t)m, reservado = 0;
+    if (fwrite(firma, sizeof(firma), 1, f) != 1 ||
+        fwrite(&profundidad, sizeof(profundidad), 1, f) != 1 ||
+        fwrite(&reservado, sizeof(reservado), 1, f) != 1 ||
+        fwrite(&genes, sizeof(genes), 1, f) != 1 ||
+        fwrite(&bases, sizeof(bases), 1, f) != 1)
+        return CARGA_ERROR_ESCRITURA;
+    return CARGA_OK;
+}
+
+int construir_indice_externo(const char* archivo, const char* salida, int m,
+                             size_t limite, ResumenExterno* resumen) {
+    if (m <= 0 || m > EXTERNO_MAX_M) return CARGA_ERROR_FORMATO;
+
+    /* El tamaño del archivo acota la cantidad de genes */
+    FILE* f = fopen(archivo, "rb");
+    if (!f) return CARGA_ERROR_ARCHIVO;
+    fseek(f, 0, SEEK_END);
+    long bytes_archivo = ftell(f);
+    fclose(f);
+    if (bytes_archivo < 0) return CARGA_ERROR_ARCHIVO;
+    if (bytes_archivo > EXTERNO_MAX_BYTES) return CARGA_ERROR_TAMANO;
+
+    int b = elegir_prefijo(m, (size_t)bytes_archivo, limite);
+    int total = 1 << (2 * b);
+    int por_pasada = (total < EXTERNO_MAX_CUBETAS) ? total : EXTERNO_MAX_CUBETAS;
+
+    FILE* out = fopen(salida, "wb");
+    if (!out) return CARGA_ERROR_ESCRITURA;
+    int estado = escribir_cabecera(out, m, 0, 0);
+
+    size_t genes = 0, bases = 0, mayor = 0;
+    int pasadas = 0, en_disco = 0;
+    FILE* cubetas[EXTERNO_MAX_CUBETAS];
+    for (int primera = 0; primera < total && estado == CARGA_OK; primera += por_pasada) {
+        int abiertas = 0;
+        while (abiertas < por_pasada && (cubetas[abiertas] = tmpfile()) != NULL) abiertas++;
+        if (abiertas < por_pasada) estado = CARGA_ERROR_ESCRITURA;
+
+        if (estado == CARGA_OK)
+            estado = repartir(archivo, m, b, primera, por_pasada, cubetas, &bases);
+        pasadas++;
+
+        /* Las cubetas se vuelcan en orden de prefijo: el índice queda ordenado */
+        for (int i = 0; i < abiertas; i++) {
+            if (estado == CARGA_OK) estado = volcar_cubeta(cubetas[i], out, limite, &genes, &mayor, &en_disco);
+            fclose(cubetas[i]);
+        }
+    }
+    if (estado == CARGA_OK && bases < (size_t)m) estado = CARGA_ERROR_LARGO;
+
+    /* Completar la cabecera con los totales */
+    if (estado == CARGA_OK) {
+        if (fseek(out, 0, SEEK_SET) != 0) estado = CARGA_ERROR_ESCRITURA;
+        else estado = escribir_cabecera(out, m, genes, bases);
+    }
+    if (fclose(out) != 0 && estado == CARGA_OK) estado = CARGA_ERROR_ESCRITURA;
+    if (estado != CARGA_OK) {
+        remove(salida);
+        return estado;
+    }
+
+    if (resumen) {
+        resumen->bases = bases;
+        resumen->genes = genes;
+        resumen->cubetas = total;
+        resumen->pasadas = pasadas;
+        resumen->mayor_cubeta = mayor;
+        resumen->en_disco = en_disco;
+    }
+    return CARGA_OK;
+}
+
+/* ------------------------------------------------------------------------- */
+/* -------------------------- CARGA DEL ÍNDICE ----------------------------- */
+/* ------------------------------------------------------------------------- */
+
+int cargar_indice(Trie* trie, const char* archivo) {
+    FILE* f = fopen(archivo, "rb");
+    if (!f) return CARGA_ERROR_ARCHIVO;
+
+    /* El tamaño del archivo acota la cantidad de posiciones de cada registro */
+    long tam = -1;
+    if (fseek(f, 0, SEEK_END) == 0) tam = ftell(f);
+    if (tam < 0 || fseek(f, 0, SEEK_SET) != 0) {
+        fclose(f);
+        return CARGA_ERROR_ARCHIVO;
+    }
+
+    char firma[8];
+    uint32_t m, reservado;
+    uint64_t genes, bases;
+    if (fread(firma, sizeof(firma), 1, f) != 1 ||
+        fread(&m, sizeof(m), 1, f) != 1 ||
+        fread(&reservado, sizeof(reservado), 1, f) != 1 ||
+        fread(&genes, sizeof(genes), 1, f) != 1 ||
+        fread(&bases, sizeof(bases), 1, f) != 1 ||
+        memcmp(firma, INDICE_FIRMA, sizeof(firma)) != 0 ||
+        m == 0 || m > EXTERNO_MAX_M || reservado != 0 ||
+        (int)m != trie->profundidad) {
+        fclose(f);
+        return CARGA_ERROR_FORMATO;
+    }
+
+    /* Las posiciones del índice no corresponden a la secuencia almacenada */
+    if (genes > 0) trie->fuentes_mixtas = 1;
+
+    uint8_t codigos[EXTERNO_MAX_M];
+    int* posiciones = NULL;
+    uint32_t capacidad = 0;
+    int estado = CARGA_OK;
+    for (uint64_t g = 0; g < genes && estado == CARGA_OK; g++) {
+        uint64_t codigo;
+        uint32_t cantidad;
+        if (fread(&codigo, sizeof(codigo), 1, f) != 1 ||
+            fread(&cantidad, sizeof(cantidad), 1, f) != 1 ||
+            cantidad == 0 || cantidad > INT_MAX ||
+            (m < 32 && (codigo >> (2 * m)) != 0) ||
+            (uint64_t)cantidad * sizeof(uint32_t) > (uint64_t)(tam - ftell(f))) {
+            estado = CARGA_ERROR_FORMATO;
+            break;
+        }
+        if (cantidad > capacidad) {
+            int* tmp = realloc(posiciones, (size_t)cantidad * sizeof(int));
+            if (!tmp) { estado = CARGA_ERROR_MEMORIA; break; }
+            posiciones = tmp;
+            capacidad = cantidad;
+        }
+        for (uint32_t i = 0; i < cantidad; i++) {
+            uint32_t p;
+            if (fread(&p, sizeof(p), 1, f) != 1 || p > INT_MAX) { estado = CARGA_ERROR_FORMATO; break; }
+            posiciones[i] = (int)p;
+        }
+        if (estado != CARGA_OK) break;
+
+        /* La primera base está en los bits más significativos */
+        for (uint32_t i = 0; i < m; i++)
+            codigos[m - 1 - i] = (uint8_t)((codigo >> (2 * i)) & 3u);
+        if (insertar_posiciones(trie, codigos, posiciones, (int)cantidad) != 0)
+            estado = CARGA_ERROR_MEMORIA;
+    }
+    free(posiciones);
+    fclose(f);
+    return estado;
+}
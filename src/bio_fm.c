@@ -0,0 +1,258 @@
+/**
+ * @file bio_fm.c
+ * @brief Implementación del arreglo de sufijos (SA-IS) y del FM-index.
+ *
+ * Este archivo contiene:
+ * - El algoritmo SA-IS (Nong, Zhang y Chan, 2009), que ordena los sufijos
+ *   en tiempo lineal clasificándolos en tipo L o S, ordenando primero las
+ *   subcadenas LMS e induciendo el orden del resto.
+ * - La construcción de la BWT y de la tabla de ocurrencias.
+ * - La búsqueda hacia atrás (backward search) de un gen.
+ *
+ * SA-IS se aplica primero sobre el texto de bytes y, de forma recursiva,
+ * sobre el texto reducido de enteros; por eso las funciones internas
+ * reciben el tamaño del símbolo `cs`.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "bio_fm.h"
+#include "bio_func.h"
+#include "bio_simd.h"
+
+/* ------------------------------------------------------------------------- */
+/* --------------------------------- SA-IS --------------------------------- */
+/* ------------------------------------------------------------------------- */
+
+/** @brief Símbolo i del texto, que puede ser de bytes o de enteros. */
+#define SIMBOLO(i) (cs == (int)sizeof(int) ? ((const int*)s)[i] : ((const uint8_t*)s)[i])
+
+/** @brief Indica si la posición i es el inicio de una subcadena LMS. */
+#define ES_LMS(i) ((i) > 0 && t[i] && !t[(i) - 1])
+
+/**
+ * @brief Calcula el inicio (fin = 0) o el final (fin = 1) de la cubeta de
+ *        cada símbolo 0..K dentro del arreglo de sufijos.
+ */
+static void obtener_cubetas(const void* s, int* cubetas, int n, int K, int cs, int fin) {
+    memset(cubetas, 0, (size_t)(K + 1) * sizeof(int));
+    for (int i = 0; i < n; i++) cubetas[SIMBOLO(i)]++;
+    int suma = 0;
+    for (int i = 0; i <= K; i++) {
+        suma += cubetas[i];
+        cubetas[i] = fin ? suma : suma - cubetas[i];
+    }
+}
+
+/**
+ * @brief Induce el orden de los sufijos tipo L a partir de los ya ubicados.
+ */
+static void inducir_L(const uint8_t* t, int* SA, const void* s, int* cubetas, int n, int K, int cs) {
+    obtener_cubetas(s, cubetas, n, K, cs, 0);
+    for (int i = 0; i < n; i++) {
+        int j = SA[i] - 1;
+        if (SA[i] > 0 && !t[j]) SA[cubetas[SIMBOLO(j)]++] = j;
+    }
+}
+
+/**
+ * @brief Induce el orden de los sufijos tipo S a partir de los tipo L.
+ */
+static void inducir_S(const uint8_t* t, int* SA, const void* s, int* cubetas, int n, int K, int cs) {
+    obtener_cubetas(s, cubetas, n, K, cs, 1);
+    for (int i = n - 1; i >= 0; i--) {
+        int j = SA[i] - 1;
+        if (SA[i] > 0 && t[j]) SA[--cubetas[SIMBOLO(j)]] = j;
+    }
+}
+
+/**
+ * @brief Construye el arreglo de sufijos de s.
+ *
+ * @param s  Texto de n símbolos entre 0 y K; el último debe ser 0 y único.
+ * @param SA Arreglo de salida de n enteros.
+ * @param n  Largo del texto (al menos 2).
+ * @param K  Mayor símbolo posible.
+ * @param cs Tamaño en bytes de cada símbolo (1 o sizeof(int)).
+ *
+ * @return 0 si se construyó, -1 si faltó memoria.
+ */
+static int sais(const void* s, int* SA, int n, int K, int cs) {
+    uint8_t* t = malloc((size_t)n);
+    int* cubetas = malloc((size_t)(K + 1) * sizeof(int));
+    if (!t || !cubetas) { free(t); free(cubetas); return -1; }
+
+    /* Clasificar cada sufijo: S (1) si es menor que el siguiente, L (0) si no */
+    t[n - 1] = 1;
+    t[n - 2] = 0;
+    for (int i = n - 3; i >= 0; i--)
+        t[i] = (SIMBOLO(i) < SIMBOLO(i + 1) || (SIMBOLO(i) == SIMBOLO(i + 1) && t[i + 1])) ? 1 : 0;
+
+    /* Etapa 1: ordenar las subcadenas LMS por inducción */
+    obtener_cubetas(s, cubetas, n, K, cs, 1);
+    for (int i = 0; i < n; i++) SA[i] = -1;
+    for (int i = 1; i < n; i++)
+        if (ES_LMS(i)) SA[--cubetas[SIMBOLO(i)]] = i;
+    inducir_L(t, SA, s, cubetas, n, K, cs);
+    inducir_S(t, SA, s, cubetas, n, K, cs);
+
+    /* Compactar las subcadenas LMS ordenadas al inicio de SA */
+    int n1 = 0;
+    for (int i = 0; i < n; i++)
+        if (ES_LMS(SA[i])) SA[n1++] = SA[i];
+
+    /* Nombrar cada subcadena LMS; iguales reciben el mismo nombre */
+    for (int i = n1; i < n; i++) SA[i] = -1;
+    int nombre = 0, previo = -1;
+    for (int i = 0; i < n1; i++) {
+        int pos = SA[i], distinta = 0;
+        for (int d = 0; d < n; d++) {
+            if (previo == -1 || SIMBOLO(pos + d) != SIMBOLO(previo + d) || t[pos + d] != t[previo + d]) {
+                distinta = 1;
+                break;
+            } else if (d > 0 && (ES_LMS(pos + d) || ES_LMS(previo + d))) {
+                break;
+            }
+        }
+        if (distinta) { nombre++; previo = pos; }
+        SA[n1 + pos / 2] = nombre - 1;
+    }
+    for (int i = n - 1, j = n - 1; i >= n1; i--)
+        if (SA[i] >= 0) SA[j--] = SA[i];
+
+    /* Etapa 2: ordenar el texto reducido (recursivamente si hay nombres repetidos) */
+    int* SA1 = SA;
+    int* s1 = SA + n - n1;
+    if (nombre < n1) {
+        if (sais(s1, SA1, n1, nombre - 1, (int)sizeof(int)) != 0) {
+            free(t); free(cubetas);
+            return -1;
+        }
+    } else {
+        for (int i = 0; i < n1; i++) SA1[s1[i]] = i;
+    }
+
+    /* Etapa 3: ubicar los sufijos LMS ya ordenados e inducir el resto */
+    obtener_cubetas(s, cubetas, n, K, cs, 1);
+    for (int i = 1, j = 0; i < n; i++)
+        if (ES_LMS(i)) s1[j++] = i;
+    for (int i = 0; i < n1; i++) SA1[i] = s1[SA1[i]];
+    for (int i = n1; i < n; i++) SA[i] = -1;
+    for (int i = n1 - 1; i >= 0; i--) {
+        int j = SA[i];
+        SA[i] = -1;
+        SA[--cubetas[SIMBOLO(j)]] = j;
+    }
+    inducir_L(t, SA, s, cubetas, n, K, cs);
+    inducir_S(t, SA, s, cubetas, n, K, cs);
+
+    free(cubetas);
+    free(t);
+    return 0;
+}
+
+/* ------------------------------------------------------------------------- */
+/* --------------------------- CONSTRUCCIÓN FM ----------------------------- */
+/* ------------------------------------------------------------------------- */
+
+void liberar_indice_fm(IndiceFM* fm) {
+    if (!fm) return;
+    free(fm->sa);
+    free(fm->bwt);
+    free(fm->ocurrencias);
+    free(fm);
+}
+
+int construir_indice_fm(Trie* trie) {
+    size_t n = trie->largo + 1;
+    IndiceFM* fm = calloc(1, sizeof(IndiceFM));
+    uint8_t* texto = malloc(n);
+    if (fm) {
+        fm->largo = n;
+        fm->sa = malloc(n * sizeof(int));
+        fm->bwt = malloc(n);
+        fm->ocurrencias = calloc((n / FM_BLOQUE + 1) * FM_SIMBOLOS, sizeof(uint32_t));
+    }
+    if (!fm || !texto || !fm->sa || !fm->bwt || !fm->ocurrencias) {
+        liberar_indice_fm(fm);
+        free(texto);
+        return CARGA_ERROR_MEMORIA;
+    }
+
+    /* Texto: A..T -> 1..4, inválida -> 5, terminador -> 0 */
+    for (size_t i = 0; i + 1 < n; i++) texto[i] = (uint8_t)(base_en(trie, i) + 1);
+    texto[n - 1] = 0;
+
+    if (sais(texto, fm->sa, (int)n, FM_SIMBOLOS - 1, 1) != 0) {
+        liberar_indice_fm(fm);
+        free(texto);
+        return CARGA_ERROR_MEMORIA;
+    }
+
+    /* BWT[i] = símbolo anterior al sufijo SA[i] y conteos por bloque */
+    size_t conteo[FM_SIMBOLOS] = {0};
+    for (size_t i = 0; i < n; i++) {
+        if (i % FM_BLOQUE == 0)
+            for (int c = 0; c < FM_SIMBOLOS; c++)
+                fm->ocurrencias[(i / FM_BLOQUE) * FM_SIMBOLOS + c] = (uint32_t)conteo[c];
+        int p = fm->sa[i];
+        fm->bwt[i] = (p > 0) ? texto[p - 1] : texto[n - 1];
+        conteo[fm->bwt[i]]++;
+    }
+    /* rango(fm, c, n) lee el bloque n / FM_BLOQUE, que el lazo no alcanza si n es múltiplo */
+    if (n % FM_BLOQUE == 0)
+        for (int c = 0; c < FM_SIMBOLOS; c++)
+            fm->ocurrencias[(n / FM_BLOQUE) * FM_SIMBOLOS + c] = (uint32_t)conteo[c];
+    size_t acumulado = 0;
+    for (int c = 0; c < FM_SIMBOLOS; c++) {
+        fm->c[c] = acumulado;
+        acumulado += conteo[c];
+    }
+    free(texto);
+
+    liberar_indice_fm(trie->fm);
+    trie->fm = fm;
+    return CARGA_OK;
+}
+
+/* ------------------------------------------------------------------------- */
+/* ------------------------------ BÚSQUEDA --------------------------------- */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @brief Cantidad de apariciones del símbolo c en BWT[0, i).
+ */
+static size_t rango(const IndiceFM* fm, int c, size_t i) {
+    size_t bloque = i / FM_BLOQUE;
+    size_t r = fm->ocurrencias[bloque * FM_SIMBOLOS + (size_t)c];
+    for (size_t j = bloque * FM_BLOQUE; j < i; j++)
+        r += (fm->bwt[j] == c);
+    return r;
+}
+
+static int comparar_enteros(const void* a, const void* b) {
+    int x = *(const int*)a, y = *(const int*)b;
+    return (x > y) - (x < y);
+}
+
+int buscar_fm(const IndiceFM* fm, const uint8_t* codigos, int largo, int** posiciones) {
+    *posiciones = NULL;
+
+    /* Búsqueda hacia atrás: [ini, fin) son los sufijos que comienzan con el sufijo del gen */
+    size_t ini = 0, fin = fm->largo;
+    for (int k = largo - 1; k >= 0 && ini < fin; k--) {
+        int c = codigos[k] + 1;
+        ini = fm->c[c] + rango(fm, c, ini);
+        fin = fm->c[c] + rango(fm, c, fin);
+    }
+    if (ini >= fin) return 0;
+
+    int cantidad = (int)(fin - ini);
+    int* res = malloc((size_t)cantidad * sizeof(int));
+    if (!res) return -1;
+    memcpy(res, fm->sa + ini, (size_t)cantidad * sizeof(int));
+    qsort(res, (size_t)cantidad, sizeof(int), comparar_enteros);
+    *posiciones = res;
+    return cantidad;
+}
@@ -4,7 +4,7 @@
  *        e inserción de genes en un Trie 4-ario utilizado para el análisis de ADN.
  *
  * Este módulo implementa:
- * - La construcción recursiva del árbol Trie de altura m.
+ * - La construcción del árbol Trie de altura m, creando nodos bajo demanda.
  * - La conversión de caracteres de ADN a índices (A,C,G,T).
  * - La inserción de apariciones de genes dentro de nodos hoja.
  * - La liberación completa y segura de toda la estructura.
@@ -20,58 +20,116 @@
 #include <ctype.h>
 #include "bio_struct.h"
 #include "bio_func.h"
+#include "bio_simd.h"
+#include "bio_fm.h"
+#include "bio_bloom.h"
+#include "bio_kernels.h"
 
 /* ------------------------------------------------------------------------- */
-/* ----------------------- CREACIÓN DEL TRIE (RECURSIVA) -------------------- */
+/* --------------------------- CREACIÓN DEL TRIE --------------------------- */
 /* ------------------------------------------------------------------------- */
 
-Nodo* crear_nodo_recursivo(int nivel_actual, int profundidad_total) 
+Nodo* crear_nodo(int es_hoja)
 {
     /**
-     * @brief Crea un nodo del Trie y, si no es hoja, crea sus 4 hijos recursivamente.
+     * @brief Crea un nodo vacío del Trie, sin hijos ni posiciones.
      *
-     * @param nivel_actual      Nivel en el que se está creando el nodo.
-     * @param profundidad_total Nivel máximo (profundidad m) del Trie.
+     * @param es_hoja 1 si el nodo está en el nivel m.
      *
-     * La función genera un árbol completamente expandido desde la raíz
-     * hasta todas las hojas, representando los 4^m posibles genes.
+     * Los nodos se crean a medida que se insertan genes, de modo que el
+     * árbol solo contiene los caminos de genes presentes en S.
      */
 
     Nodo* nodo = (Nodo*)malloc(sizeof(Nodo));
     if (!nodo) return NULL;
-    nodo->esHoja = (nivel_actual == profundidad_total);
+    nodo->esHoja = es_hoja;
     nodo->posiciones = NULL;
     nodo->numPosiciones = 0;
 
     /* Inicializar hijos */
     for (int i = 0; i < 4; i++) nodo->hijos[i] = NULL;
-
-    /* Si no es hoja, crear subárboles */
-    if (!nodo->esHoja) {
-        for (int i = 0; i < 4; i++) {
-            nodo->hijos[i] = crear_nodo_recursivo(nivel_actual + 1, profundidad_total);
-        }
-    }
     return nodo;
 }
 
 
-void inicializar_trie(Trie* trie, int profundidad) {
+int inicializar_trie(Trie* trie, int profundidad) {
     /**
-     * @brief Construye un Trie completamente expandido a partir de la profundidad m.
+     * @brief Inicializa un Trie vacío (solo la raíz) de profundidad m.
      *
      * @param trie        Puntero a la estructura Trie a inicializar.
      * @param profundidad Profundidad total del árbol (longitud del gen m).
+     * @return 0 si se creó la raíz, -1 si no hubo memoria.
      */
 
     trie->profundidad = profundidad;
+    trie->distintos = 0;
+    trie->secuencia = NULL;
+    trie->mascara_n = NULL;
+    trie->largo = 0;
+    trie->fm = NULL;
+    trie->solo_conteo = 0;
+    trie->bloom = NULL;
+    trie->fuentes_mixtas = 0;
+    trie->kernel = seleccionar_kernel(profundidad);
+
+    trie->raiz = crear_nodo(profundidad == 0);
+    return trie->raiz ? 0 : -1;
+}
+
+int activar_conteo(Trie* trie, int con_filtro) {
+    /**
+     * @brief Pasa un Trie recién inicializado al modo de solo conteo.
+     *
+     * @param trie       Trie sin genes insertados.
+     * @param con_filtro 1 para crear además el filtro de Bloom.
+     * @return 0 si se activó, -1 si no hubo memoria para el filtro.
+     */
+
+    trie->solo_conteo = 1;
+    if (con_filtro) {
+        trie->bloom = crear_bloom(MAX_SECUENCIA);
+        if (!trie->bloom) return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Bytes que ocupa en el heap un bloque pedido a malloc: el pedido más
+ *        la cabecera del bloque, redondeado a 16 y con un mínimo de 32
+ *        (valores de glibc en 64 bits; otras bibliotecas son similares).
+ */
+static double bloque_malloc(size_t pedido) {
+    size_t bloque = (pedido + sizeof(size_t) + 15) & ~(size_t)15;
+    return (double)(bloque < 32 ? 32 : bloque);
+}
 
-    trie->raiz = crear_nodo_recursivo(0, profundidad);
+double estimar_memoria_trie(int profundidad, size_t bases, int solo_conteo) {
+    /**
+     * @brief Estimación de la memoria usada al indexar una secuencia.
+     *
+     * @param profundidad Profundidad m del Trie.
+     * @param bases       Cantidad de bases de la secuencia.
+     * @param solo_conteo 1 si las hojas no guardan posiciones.
+     * @return Bytes estimados.
+     */
 
-    if (!trie->raiz) {
-        fprintf(stderr, "Error: no se pudo crear el arbol.\n");
-        exit(1);
+    /* En el nivel d hay a lo sumo min(4^d, bases) nodos; el último nivel son las hojas */
+    double nodos = 1.0, nivel = 1.0, hojas = 1.0;
+    for (int d = 1; d <= profundidad; d++) {
+        if (nivel < (double)bases) nivel *= 4.0;
+        hojas = (nivel < (double)bases) ? nivel : (double)bases;
+        nodos += hojas;
     }
+
+    /* Cada hoja es un bloque propio de posiciones: 4 bytes por posición más
+       a lo sumo 28 de cabecera y redondeo (un bloque de 32 para una sola) */
+    double posiciones = solo_conteo ? 0.0
+        : (double)bases * sizeof(int) + hojas * (bloque_malloc(sizeof(int)) - sizeof(int));
+
+    return nodos * bloque_malloc(sizeof(Nodo))
+         + posiciones
+         + (double)bases / 4.0 + (double)bases / 8.0  /* secuencia empaquetada y máscara */
+         + MAX_SECUENCIA + (double)bases;             /* buffers temporales de lectura y códigos */
 }
 
 /* ------------------------------------------------------------------------- */
@@ -100,6 +158,10 @@ void liberar_trie(Trie* trie) {
 
     if (!trie) return;
     liberar_nodo(trie->raiz);
+    free(trie->secuencia);
+    free(trie->mascara_n);
+    liberar_indice_fm(trie->fm);
+    liberar_bloom(trie->bloom);
     free(trie);
 }
 
@@ -128,13 +190,60 @@ int char_a_indice(char c) {
 /* --------------------------- INSERCIÓN DE GENES --------------------------- */
 /* ------------------------------------------------------------------------- */
 
+/**
+ * @brief Retorna el hijo indicado de un nodo, creándolo si aún no existe.
+ *
+ * @param padre   Nodo actual.
+ * @param indice  Índice del hijo (0..3).
+ * @param es_hoja 1 si el hijo está en el nivel m.
+ * @return El hijo, o NULL si no hubo memoria para crearlo.
+ */
+static Nodo* hijo_o_crear(Nodo* padre, int indice, int es_hoja)
+{
+    if (!padre->hijos[indice])
+        padre->hijos[indice] = crear_nodo(es_hoja);
+    return padre->hijos[indice];
+}
+
+int agregar_posiciones(Trie* trie, Nodo* hoja, const int* posiciones, int cantidad)
+{
+    /**
+     * @brief Agrega posiciones al final del arreglo dinámico de una hoja.
+     *
+     * @param trie       Trie al que pertenece la hoja (lleva la cuenta de genes distintos).
+     * @param hoja       Nodo hoja del gen.
+     * @param posiciones Posiciones de inicio del gen dentro de la secuencia S.
+     * @param cantidad   Cantidad de posiciones a agregar.
+     * @return 0 si se agregaron, -1 si falló realloc (la hoja queda intacta).
+     */
+
+    hoja->esHoja = 1;
+    if (hoja->numPosiciones == 0 && cantidad > 0) trie->distintos++;
+
+    /* En el modo de solo conteo basta con sumar las apariciones */
+    if (trie->solo_conteo) {
+        hoja->numPosiciones += cantidad;
+        return 0;
+    }
+
+    /* Redimensionar arreglo dinámico de posiciones */
+    int *tmp = (int*)realloc(hoja->posiciones, (size_t)(hoja->numPosiciones + cantidad) * sizeof(int));
+    if (!tmp)
+        return -1; /* Si falla realloc, no insertamos */
+    hoja->posiciones = tmp;
+    memcpy(hoja->posiciones + hoja->numPosiciones, posiciones, (size_t)cantidad * sizeof(int));
+    hoja->numPosiciones += cantidad;
+    return 0;
+}
+
 void insertar_en_trie(Trie* trie, const char* secuencia, int posicion) 
 {
     /**
      * @brief Inserta un gen (cadena de longitud m) dentro del Trie.
      *
      * La inserción consiste en:
-     * 1. Navegar desde la raíz siguiendo cada base nitrogenada.
+     * 1. Navegar desde la raíz siguiendo cada base nitrogenada, creando
+     *    los nodos que falten.
      * 2. Al llegar a la hoja, expandir su arreglo dinámico de posiciones.
      *
      * @param trie      Trie ya inicializado mediante `bio start`.
@@ -153,17 +262,221 @@ void insertar_en_trie(Trie* trie, const char* secuencia, int posicion)
         int indice = char_a_indice(secuencia[i]);
         if (indice < 0) 
             return; /* Carácter inválido */
-        if (!actual->hijos[indice]) 
-            return; /* Camino inconsistente (no debería ocurrir en Trie expandido) */
 
-        actual = actual->hijos[indice];
+        actual = hijo_o_crear(actual, indice, i + 1 == trie->profundidad);
+        if (!actual) 
+            return; /* Sin memoria para el nuevo nodo */
     }
-    actual->esHoja = 1;
+    agregar_posiciones(trie, actual, &posicion, 1);
+}
 
-    /* Redimensionar arreglo dinámico de posiciones */
-    int *tmp = (int*)realloc(actual->posiciones, (size_t)(actual->numPosiciones + 1) * sizeof(int));
-    if (!tmp) 
-        return; /* Si falla realloc, no insertamos */
-    actual->posiciones = tmp;
-    actual->posiciones[actual->numPosiciones++] = posicion;
-}
\ No newline at end of file
+int insertar_posiciones(Trie* trie, const uint8_t* codigos, const int* posiciones, int cantidad)
+{
+    /**
+     * @brief Inserta varias apariciones de un gen ya convertido a códigos 0..3.
+     *
+     * @param trie       Trie ya inicializado.
+     * @param codigos    m códigos válidos (sin BASE_INVALIDA).
+     * @param posiciones Posiciones de inicio del gen dentro de la secuencia S.
+     * @param cantidad   Cantidad de posiciones.
+     * @return 0 si se insertó, -1 si no hubo memoria.
+     */
+
+    Nodo* actual = trie->raiz;
+    for (int i = 0; i < trie->profundidad; i++)
+    {
+        actual = hijo_o_crear(actual, codigos[i], i + 1 == trie->profundidad);
+        if (!actual)
+            return -1; /* Sin memoria para el nuevo nodo */
+    }
+    return agregar_posiciones(trie, actual, posiciones, cantidad);
+}
+
+int insertar_codigos(Trie* trie, const uint8_t* codigos, int posicion)
+{
+    /**
+     * @brief Inserta un gen ya convertido a códigos 0..3.
+     *
+     * Con filtro de Bloom, un gen que aún no está en el Trie solo se agrega
+     * si el filtro indica que ya fue visto; entra entonces con conteo 2.
+     *
+     * @param trie      Trie ya inicializado.
+     * @param codigos   m códigos válidos (sin BASE_INVALIDA).
+     * @param posicion  Posición de inicio del gen dentro de la secuencia S.
+     * @return 0 si se insertó (o quedó solo en el filtro), -1 si no hubo memoria.
+     */
+
+    if (!trie->bloom)
+        return insertar_posiciones(trie, codigos, &posicion, 1);
+
+    /* Bajar por los nodos existentes; el filtro decide si se crea el resto */
+    Nodo* actual = trie->raiz;
+    int i = 0;
+    while (i < trie->profundidad && actual->hijos[codigos[i]])
+        actual = actual->hijos[codigos[i++]];
+    int cantidad = 1;
+    if (i < trie->profundidad) {
+        if (!bloom_visto(trie->bloom, codigos, trie->profundidad))
+            return 0; /* Primera aparición: solo queda marcada en el filtro */
+        cantidad = 2;
+    }
+    for (; i < trie->profundidad; i++) {
+        actual = hijo_o_crear(actual, codigos[i], i + 1 == trie->profundidad);
+        if (!actual)
+            return -1;
+    }
+    return agregar_posiciones(trie, actual, &posicion, cantidad);
+}
+
+/* ------------------------------------------------------------------------- */
+/* --------------------------- CARGA DE SECUENCIAS -------------------------- */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @brief Lee el archivo, lo convierte a códigos 0..3 (o BASE_INVALIDA) y
+ *        reemplaza la secuencia S almacenada en el Trie.
+ *
+ * La normalización y la conversión a códigos se realizan por bloques con
+ * las rutinas vectorizadas de bio_simd.c.
+ *
+ * @param codigos_out Recibe los códigos de S; debe liberarse con free().
+ * @param largo_out   Recibe la cantidad de bases de S.
+ * @return CARGA_OK o un código CARGA_ERROR_* (sin nada que liberar).
+ */
+static int leer_codigos(Trie* trie, const char* filename, uint8_t** codigos_out, size_t* largo_out)
+{
+    FILE* file = fopen(filename, "rb");
+    if (!file) return CARGA_ERROR_ARCHIVO;
+
+    int m = trie->profundidad;
+    char *secuencia = malloc(MAX_SECUENCIA);
+    if (!secuencia) { fclose(file); return CARGA_ERROR_MEMORIA; }
+    size_t len = 0;
+
+    /* Leer por bloques y normalizar en el mismo buffer (mayúsculas, sin saltos) */
+    size_t leidos;
+    while (len < MAX_SECUENCIA &&
+           (leidos = fread(secuencia + len, 1, MAX_SECUENCIA - len, file)) > 0) {
+        len += normalizar_bases(secuencia + len, secuencia + len, leidos);
+    }
+    fclose(file);
+    if (len < (size_t)m) { free(secuencia); return CARGA_ERROR_LARGO; }
+
+    uint8_t *codigos = malloc(len);
+    if (!codigos) { free(secuencia); return CARGA_ERROR_MEMORIA; }
+    size_t invalidos = codificar_bases(codigos, secuencia, len);
+    free(secuencia);
+
+    /* Conservar S empaquetada a 2 bits y la máscara de bases inválidas */
+    uint8_t *empaquetada = malloc((len + 3) / 4);
+    uint8_t *mascara = calloc((len + 7) / 8, 1);
+    if (!empaquetada || !mascara) {
+        free(empaquetada); free(mascara); free(codigos);
+        return CARGA_ERROR_MEMORIA;
+    }
+    empaquetar_2bits(empaquetada, codigos, len);
+    for (size_t i = 0; invalidos > 0 && i < len; i++) {
+        if (codigos[i] == BASE_INVALIDA) {
+            mascara[i / 8] |= (uint8_t)(1u << (i % 8));
+            invalidos--;
+        }
+    }
+    free(trie->secuencia);
+    free(trie->mascara_n);
+    liberar_indice_fm(trie->fm); /* Indexaba la secuencia anterior */
+    trie->fm = NULL;
+    trie->secuencia = empaquetada;
+    trie->mascara_n = mascara;
+    trie->largo = len;
+    /* Las posiciones de lecturas anteriores se conservan pero ya no indexan S */
+    if (trie->distintos > 0) trie->fuentes_mixtas = 1;
+
+    *codigos_out = codigos;
+    *largo_out = len;
+    return CARGA_OK;
+}
+
+int leer_secuencia(Trie* trie, const char* filename)
+{
+    /**
+     * @brief Reemplaza la secuencia S almacenada sin insertar genes en el Trie.
+     *
+     * Los genes de lecturas anteriores se descartan, ya que no corresponden
+     * a la nueva S: el árbol queda vacío.
+     *
+     * @param trie     Trie ya inicializado.
+     * @param filename Ruta del archivo de la secuencia S.
+     * @return CARGA_OK o un código CARGA_ERROR_*.
+     */
+
+    Nodo* raiz = crear_nodo(trie->profundidad == 0);
+    if (!raiz) return CARGA_ERROR_MEMORIA;
+    uint8_t* codigos;
+    size_t len;
+    int estado = leer_codigos(trie, filename, &codigos, &len);
+    if (estado != CARGA_OK) { free(raiz); return estado; }
+    free(codigos);
+
+    liberar_nodo(trie->raiz);
+    trie->raiz = raiz;
+    trie->distintos = 0;
+    trie->fuentes_mixtas = 0;
+    if (trie->bloom)
+        memset(trie->bloom->bits, 0, (trie->bloom->num_bits + 63) / 64 * sizeof(uint64_t));
+    return CARGA_OK;
+}
+
+int cargar_secuencia(Trie* trie, const char* filename)
+{
+    /**
+     * @brief Lee el archivo, almacena la secuencia y la indexa con una
+     *        ventana deslizante de tamaño m.
+     *
+     * La ventana deslizante solo consulta cuántas bases válidas consecutivas
+     * lleva.
+     *
+     * @param trie     Trie ya inicializado.
+     * @param filename Ruta del archivo de la secuencia S.
+     * @return CARGA_OK o un código CARGA_ERROR_*.
+     */
+
+    uint8_t* codigos;
+    size_t len;
+    int m = trie->profundidad;
+    int estado = leer_codigos(trie, filename, &codigos, &len);
+    if (estado != CARGA_OK) return estado;
+
+    /* Ventana deslizante tamaño m: se inserta si las últimas m bases son válidas.
+       Lo insertado antes de un error de memoria permanece en el Trie. */
+    if (trie->kernel && !trie->bloom) {
+        /* m fijo en compilación (bio_kernels.c) */
+        if (trie->kernel->indexar(trie, codigos, len) != 0) estado = CARGA_ERROR_MEMORIA;
+    } else {
+        size_t racha = 0;
+        for (size_t i = 0; i < len; i++) {
+            racha = (codigos[i] == BASE_INVALIDA) ? 0 : racha + 1;
+            if (racha >= (size_t)m &&
+                insertar_codigos(trie, &codigos[i + 1 - (size_t)m], (int)(i + 1 - (size_t)m)) != 0) {
+                estado = CARGA_ERROR_MEMORIA;
+                break;
+            }
+        }
+    }
+    free(codigos);
+    return estado;
+}
+
+int base_en(const Trie* trie, size_t posicion)
+{
+    /**
+     * @brief Obtiene el código de la base almacenada en una posición de S.
+     *
+     * @param trie     Trie con la secuencia S cargada.
+     * @param posicion Posición dentro de S (debe ser menor que trie->largo).
+     * @return Código 0..3, o BASE_INVALIDA si la base no es A, C, G ni T.
+     */
+
+    if ((trie->mascara_n[posicion / 8] >> (posicion % 8)) & 1u)
+        return BASE_INVALIDA;
+    return (trie->secuencia[posicion / 4] >> (2 * (posicion % 4))) & 3;
+}
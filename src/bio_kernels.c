@@ -0,0 +1,116 @@
+/**
+ * @file bio_kernels.c
+ * @brief Generación de las rutinas especializadas por m del Trie.
+ *
+ * Las funciones base reciben m como parámetro y se fuerzan en línea; cada
+ * instancia generada por DEFINIR_KERNEL las invoca con m literal, por lo que
+ * los lazos tienen cantidad de vueltas constante y se desenrollan.
+ */
+
+#include <stdint.h>
+
+#include "bio_kernels.h"
+#include "bio_func.h"
+#include "bio_simd.h"
+
+#if defined(__GNUC__)
+#define SIEMPRE_EN_LINEA inline __attribute__((always_inline))
+#define DESENROLLAR _Pragma("GCC unroll 32")
+#else
+#define SIEMPRE_EN_LINEA inline
+#define DESENROLLAR
+#endif
+
+/** @brief Máscara de los 2·m bits de un gen (válida para 1 <= m <= 32). */
+#define MASCARA_GEN(M) (UINT64_MAX >> (64 - 2 * (M)))
+
+/**
+ * @brief Desciende hasta la hoja de un gen codificado en 64 bits, creando
+ *        los nodos que falten. La primera base está en los bits más altos.
+ */
+static SIEMPRE_EN_LINEA Nodo* descender_creando(Trie* trie, uint64_t codigo, const int M) {
+    Nodo* act = trie->raiz;
+    DESENROLLAR
+    for (int i = 0; i < M; i++) {
+        int c = (int)((codigo >> (2 * (M - 1 - i))) & 3u);
+        if (!act->hijos[c] && !(act->hijos[c] = crear_nodo(i + 1 == M)))
+            return NULL;
+        act = act->hijos[c];
+    }
+    return act;
+}
+
+/**
+ * @brief Inserta todas las ventanas válidas de largo M de la secuencia.
+ */
+static SIEMPRE_EN_LINEA int indexar_base(Trie* trie, const uint8_t* codigos, size_t largo, const int M) {
+    const uint64_t mascara = MASCARA_GEN(M);
+    uint64_t codigo = 0;
+    int racha = 0;
+    for (size_t i = 0; i < largo; i++) {
+        if (codigos[i] == BASE_INVALIDA) { racha = 0; continue; }
+        codigo = ((codigo << 2) | codigos[i]) & mascara;
+        if (racha < M) racha++;
+        if (racha < M) continue;
+
+        int pos = (int)(i + 1 - (size_t)M);
+        Nodo* hoja = descender_creando(trie, codigo, M);
+        if (!hoja || agregar_posiciones(trie, hoja, &pos, 1) != 0)
+            return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Hoja de un gen de M códigos, o NULL si no está en el Trie.
+ */
+static SIEMPRE_EN_LINEA Nodo* buscar_base(const Trie* trie, const uint8_t* codigos, const int M) {
+    Nodo* act = trie->raiz;
+    DESENROLLAR
+    for (int i = 0; i < M; i++) {
+        act = act->hijos[codigos[i]];
+        if (!act) return NULL;
+    }
+    return act;
+}
+
+#define DEFINIR_KERNEL(M) \
+    static int indexar_##M(Trie* trie, const uint8_t* codigos, size_t largo) { \
+        return indexar_base(trie, codigos, largo, M); \
+    } \
+    static Nodo* buscar_##M(const Trie* trie, const uint8_t* codigos) { \
+        return buscar_base(trie, codigos, M); \
+    }
+
+DEFINIR_KERNEL(4)  DEFINIR_KERNEL(5)  DEFINIR_KERNEL(6)  DEFINIR_KERNEL(7)
+DEFINIR_KERNEL(8)  DEFINIR_KERNEL(9)  DEFINIR_KERNEL(10) DEFINIR_KERNEL(11)
+DEFINIR_KERNEL(12) DEFINIR_KERNEL(13) DEFINIR_KERNEL(14) DEFINIR_KERNEL(15)
+DEFINIR_KERNEL(16) DEFINIR_KERNEL(17) DEFINIR_KERNEL(18) DEFINIR_KERNEL(19)
+DEFINIR_KERNEL(20) DEFINIR_KERNEL(21) DEFINIR_KERNEL(22) DEFINIR_KERNEL(23)
+DEFINIR_KERNEL(24) DEFINIR_KERNEL(25) DEFINIR_KERNEL(26) DEFINIR_KERNEL(27)
+DEFINIR_KERNEL(28) DEFINIR_KERNEL(29) DEFINIR_KERNEL(30) DEFINIR_KERNEL(31)
+DEFINIR_KERNEL(32)
+
+#define KERNEL(M) { M, indexar_##M, buscar_##M }
+
+static const KernelTrie kernels[KERNEL_MAX_M - KERNEL_MIN_M + 1] = {
+    KERNEL(4),  KERNEL(5),  KERNEL(6),  KERNEL(7),
+    KERNEL(8),  KERNEL(9),  KERNEL(10), KERNEL(11),
+    KERNEL(12), KERNEL(13), KERNEL(14), KERNEL(15),
+    KERNEL(16), KERNEL(17), KERNEL(18), KERNEL(19),
+    KERNEL(20), KERNEL(21), KERNEL(22), KERNEL(23),
+    KERNEL(24), KERNEL(25), KERNEL(26), KERNEL(27),
+    KERNEL(28), KERNEL(29), KERNEL(30), KERNEL(31),
+    KERNEL(32)
+};
+
+const KernelTrie* seleccionar_kernel(int m) {
+#ifdef BIO_SIN_ESPECIALIZAR
+    (void)m;
+    (void)kernels;
+    return NULL;
+#else
+    if (m < KERNEL_MIN_M || m > KERNEL_MAX_M) return NULL;
+    return &kernels[m - KERNEL_MIN_M];
+#endif
+}
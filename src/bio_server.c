@@ -0,0 +1,580 @@
+/**
+ * @file bio_server.c
+ * @brief Implementación del modo servidor sobre un socket local.
+ *
+ * Este archivo contiene:
+ * - La creación del socket de escucha en la ruta solicitada.
+ * - La tabla de conexiones abiertas y una cola circular de conexiones con
+ *   un pedido pendiente, protegidas por un mutex.
+ * - El grupo de hilos trabajadores que responden cada pedido utilizando las
+ *   mismas funciones de consulta de la CLI.
+ *
+ * El hilo que invoca `bio_serve` acepta conexiones y espera con poll() a que
+ * las conexiones en reposo envíen datos; recién entonces las pone en la cola.
+ * Un trabajador atiende una sola línea por turno y devuelve la conexión, por
+ * lo que un cliente inactivo no ocupa ningún hilo. Ningún Trie publicado se
+ * modifica, por lo que las lecturas concurrentes son seguras.
+ *
+ * Recarga sin bloqueo de lectores:
+ * el índice vigente se publica en un puntero atómico. `bio reload` construye
+ * un Trie nuevo en un hilo de fondo y lo intercambia atómicamente con el
+ * actual; cada consulta toma el puntero vigente al comenzar. Para saber
+ * cuándo liberar el Trie anterior, cada trabajador anuncia en una ranura
+ * propia (puntero de riesgo, "hazard pointer") el índice que está leyendo:
+ * el viejo se libera cuando ninguna ranura lo referencia.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+
+#include "bio_server.h"
+
+#ifdef _WIN32
+
+int bio_serve(const char* ruta, Trie** trie) {
+    (void)ruta;
+    (void)trie;
+    printf("El modo servidor no esta disponible en Windows.\n");
+    return -1;
+}
+
+#else
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <time.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+
+#include "bio_commands.h"
+#include "bio_func.h"
+#include "bio_fm.h"
+
+/* ------------------------------------------------------------------------- */
+/* ------------------------- Estado compartido ----------------------------- */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @brief Conexión abierta con un cliente.
+ *
+ * Mientras `en_espera` vale 1 la conexión pertenece al hilo aceptador, que
+ * la vigila con poll(); en caso contrario la tiene la cola o un trabajador.
+ */
+typedef struct {
+    int fd;                /**< Descriptor del socket (-1 si la entrada está libre). */
+    FILE* out;             /**< Flujo de escritura sobre una copia de fd. */
+    int en_espera;         /**< 1 si espera datos en el conjunto de poll(). */
+    char buffer[MAX_CMD];  /**< Bytes recibidos que aún no forman una línea atendida. */
+    size_t usados;         /**< Bytes válidos en buffer. */
+    int descartando;       /**< 1 mientras se descarta el resto de una línea demasiado larga. */
+} Conexion;
+
+/**
+ * @brief Estado del servidor compartido entre el hilo aceptador y los trabajadores.
+ */
+typedef struct {
+    _Atomic(Trie*) indice;                /**< Índice vigente, reemplazado por `bio reload`. */
+    _Atomic(Trie*) en_uso[SERVER_HILOS];  /**< Índice que lee cada trabajador (NULL si ninguno). */
+    char archivo_recarga[MAX_ARG];   /**< Archivo de la recarga en curso. */
+    int recargando;                  /**< 1 mientras exista un hilo de recarga sin unir. */
+    pthread_t hilo_recarga;          /**< Hilo que construye el nuevo índice. */
+    Conexion conexiones[SERVER_COLA]; /**< Conexiones abiertas. */
+    int cola[SERVER_COLA];           /**< Conexiones con un pedido pendiente (índices en conexiones). */
+    int inicio;                      /**< Posición del primer elemento de la cola. */
+    int cantidad;                    /**< Cantidad de conexiones en la cola. */
+    int despertar[2];                /**< Tubería para interrumpir el poll() del hilo aceptador. */
+    int detener;                     /**< Se activa al recibir `bio shutdown`. */
+    int recarga_terminada;           /**< El hilo de recarga ya finalizó su trabajo. */
+    pthread_mutex_t mutex;           /**< Protege los campos no atómicos. */
+    pthread_cond_t hay_trabajo;      /**< Señala nuevas conexiones o la detención. */
+} Servidor;
+
+/**
+ * @brief Argumento entregado a cada hilo trabajador.
+ */
+typedef struct {
+    Servidor* srv; /**< Estado compartido. */
+    int id;        /**< Índice del hilo dentro de Servidor::en_uso. */
+} Trabajador;
+
+/* ------------------------------------------------------------------------- */
+/* ------------------ Publicación y recarga del índice --------------------- */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @brief Obtiene el índice vigente y lo anuncia en la ranura del trabajador.
+ *
+ * Se repite hasta que el puntero anunciado siga siendo el vigente; así el
+ * hilo de recarga, al revisar las ranuras después del intercambio, nunca
+ * pasa por alto a un lector del índice anterior. No bloquea.
+ */
+static Trie* adquirir_indice(Servidor* srv, int id) {
+    Trie* t;
+    do {
+        t = atomic_load(&srv->indice);
+        atomic_store(&srv->en_uso[id], t);
+    } while (t != atomic_load(&srv->indice));
+    return t;
+}
+
+/**
+ * @brief Indica que el trabajador terminó de leer el índice adquirido.
+ */
+static void soltar_indice(Servidor* srv, int id) {
+    atomic_store(&srv->en_uso[id], NULL);
+}
+
+/**
+ * @brief Espera a que ningún trabajador siga leyendo el índice indicado.
+ */
+static void esperar_lectores(Servidor* srv, const Trie* viejo) {
+    const struct timespec pausa = { 0, 1000000 }; /* 1 ms */
+    for (int i = 0; i < SERVER_HILOS; i++) {
+        while (atomic_load(&srv->en_uso[i]) == viejo) nanosleep(&pausa, NULL);
+    }
+}
+
+/**
+ * @brief Hilo de fondo: construye un Trie nuevo y lo publica.
+ *
+ * Mientras se construye, las consultas siguen respondiendo con el índice
+ * anterior. Si la carga falla, el índice vigente no cambia.
+ */
+static void* recargar_indice(void* arg) {
+    Servidor* srv = (Servidor*)arg;
+    /* Solo este hilo reemplaza o libera índices, así que `actual` sigue vivo */
+    Trie* actual = atomic_load(&srv->indice);
+
+    int estado = CARGA_ERROR_MEMORIA;
+    Trie* nuevo = (Trie*)malloc(sizeof(Trie));
+    if (nuevo && inicializar_trie(nuevo, actual->profundidad) == 0 &&
+        (!actual->solo_conteo || activar_conteo(nuevo, actual->bloom != NULL) == 0)) {
+        /* Mantener el mismo tipo de índice que el vigente: árbol o solo FM-index */
+        if (actual->fm) {
+            estado = leer_secuencia(nuevo, srv->archivo_recarga);
+            if (estado == CARGA_OK) estado = construir_indice_fm(nuevo);
+        } else {
+            estado = cargar_secuencia(nuevo, srv->archivo_recarga);
+        }
+    }
+
+    if (estado != CARGA_OK) {
+        liberar_trie(nuevo);
+        printf("Reload of %s failed (code %d)\n", srv->archivo_recarga, estado);
+    } else {
+        Trie* viejo = atomic_exchange(&srv->indice, nuevo);
+        esperar_lectores(srv, viejo);
+        liberar_trie(viejo);
+        printf("Index reloaded from %s\n", srv->archivo_recarga);
+    }
+    fflush(stdout);
+
+    pthread_mutex_lock(&srv->mutex);
+    srv->recarga_terminada = 1;
+    pthread_mutex_unlock(&srv->mutex);
+    return NULL;
+}
+
+/**
+ * @brief Inicia la reconstrucción del índice en segundo plano.
+ *
+ * @return 1 si se inició, 0 si ya había una recarga en curso o no se pudo crear el hilo.
+ */
+static int iniciar_recarga(Servidor* srv, const char* archivo) {
+    pthread_mutex_lock(&srv->mutex);
+    if (srv->recargando && !srv->recarga_terminada) {
+        pthread_mutex_unlock(&srv->mutex);
+        return 0;
+    }
+    /* Unir el hilo de una recarga anterior ya finalizada */
+    if (srv->recargando) pthread_join(srv->hilo_recarga, NULL);
+    srv->recargando = 0;
+    srv->recarga_terminada = 0;
+
+    strncpy(srv->archivo_recarga, archivo, MAX_ARG - 1);
+    srv->archivo_recarga[MAX_ARG - 1] = '\0';
+    if (pthread_create(&srv->hilo_recarga, NULL, recargar_indice, srv) == 0)
+        srv->recargando = 1;
+    int iniciado = srv->recargando;
+    pthread_mutex_unlock(&srv->mutex);
+    return iniciado;
+}
+
+/* ------------------------------------------------------------------------- */
+/* ------------------------ Atención de una conexión ----------------------- */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @brief Interrumpe el poll() del hilo aceptador.
+ *
+ * El extremo de escritura no bloquea: si la tubería está llena, el hilo
+ * aceptador ya tiene un aviso pendiente.
+ */
+static void despertar_aceptador(Servidor* srv) {
+    char c = 0;
+    ssize_t escritos = write(srv->despertar[1], &c, 1);
+    (void)escritos;
+}
+
+/**
+ * @brief Marca el servidor para detenerse y despierta a todos los hilos.
+ */
+static void solicitar_detencion(Servidor* srv) {
+    pthread_mutex_lock(&srv->mutex);
+    srv->detener = 1;
+    pthread_cond_broadcast(&srv->hay_trabajo);
+    pthread_mutex_unlock(&srv->mutex);
+    despertar_aceptador(srv);
+}
+
+/**
+ * @brief Pone una conexión al final de la cola de pedidos. Requiere el mutex.
+ *
+ * Cada conexión está a lo sumo una vez en la cola y la cola tiene lugar para
+ * todas las conexiones abiertas, por lo que nunca se llena.
+ */
+static void encolar(Servidor* srv, int i) {
+    srv->cola[(srv->inicio + srv->cantidad) % SERVER_COLA] = i;
+    srv->cantidad++;
+    pthread_cond_signal(&srv->hay_trabajo);
+}
+
+/**
+ * @brief Cierra una conexión y libera su entrada en la tabla. Requiere el mutex.
+ */
+static void cerrar_conexion(Conexion* con) {
+    fclose(con->out);
+    close(con->fd);
+    con->fd = -1;
+}
+
+/**
+ * @brief Responde una línea de comando de un cliente.
+ *
+ * Cada consulta adquiere el índice vigente por separado, de modo que una
+ * conexión larga pasa al índice nuevo en cuanto termina una recarga.
+ *
+ * @return 1 si la conexión sigue abierta, 0 tras `bio exit`, `bio shutdown`
+ *         o un error de escritura.
+ */
+static int responder(Servidor* srv, int id, const char* linea, FILE* out) {
+    Comando c;
+    parsear_comando(linea, &c);
+    if (c.cmd[0] == '\0' && !c.truncado) return 1;
+
+    if (c.truncado) {
+        informar_truncado(out);
+    } else if (strcmp(c.cmd, "bio") != 0) {
+        fprintf(out, "Comando no reconocido. Use 'bio <accion>'.\n");
+    } else if (strcmp(c.arg1, "exit") == 0) {
+        return 0;
+    } else if (strcmp(c.arg1, "shutdown") == 0) {
+        solicitar_detencion(srv);
+        return 0;
+    } else if (strcmp(c.arg1, "reload") == 0) {
+        if (c.arg2[0] == '\0')
+            fprintf(out, "Debe indicar el archivo a cargar.\n");
+        else if (iniciar_recarga(srv, c.arg2))
+            fprintf(out, "Reload started\n");
+        else
+            fprintf(out, "Ya hay una recarga en curso.\n");
+    } else {
+        Trie* trie = adquirir_indice(srv, id);
+        int atendido = ejecutar_consulta(&c, trie, out);
+        soltar_indice(srv, id);
+        if (!atendido)
+            fprintf(out, "Accion '%s' no disponible en el servidor.\n", c.arg1);
+    }
+    /* Línea vacía: fin de la respuesta */
+    fputc('\n', out);
+    return fflush(out) == 0;
+}
+
+/**
+ * @brief Atiende a lo sumo una línea de una conexión con datos disponibles.
+ *
+ * Si el buffer aún no contiene una línea completa se hace una sola lectura,
+ * que no bloquea porque poll() indicó datos. Una línea que llena el buffer
+ * sin salto se responde con un error y el resto se descarta hasta el salto,
+ * así nunca se atiende un comando recortado.
+ *
+ * @return 1 si la conexión sigue abierta, 0 si debe cerrarse.
+ */
+static int atender_pedido(Servidor* srv, int id, Conexion* con) {
+    const size_t capacidad = sizeof(con->buffer) - 1;
+    char* fin = memchr(con->buffer, '\n', con->usados);
+    int eof = 0;
+    if (!fin && con->usados < capacidad) {
+        ssize_t n = read(con->fd, con->buffer + con->usados, capacidad - con->usados);
+        if (n < 0) return errno == EINTR || errno == EAGAIN;
+        if (n == 0) eof = 1;
+        con->usados += (size_t)n;
+        fin = memchr(con->buffer, '\n', con->usados);
+    }
+
+    if (con->descartando) {
+        /* Resto de una línea demasiado larga, ya respondida con el error */
+        size_t consumidos = fin ? (size_t)(fin - con->buffer) + 1 : con->usados;
+        con->usados -= consumidos;
+        memmove(con->buffer, con->buffer + consumidos, con->usados);
+        if (fin) con->descartando = 0;
+        return !eof;
+    }
+    if (!fin && !eof && con->usados < capacidad) return 1; /* Línea incompleta */
+    if (!fin && eof && con->usados == 0) return 0;
+    if (!fin && !eof) {
+        con->usados = 0;
+        con->descartando = 1;
+        informar_truncado(con->out);
+        fputc('\n', con->out);
+        return fflush(con->out) == 0;
+    }
+
+    size_t largo = fin ? (size_t)(fin - con->buffer) : con->usados;
+    size_t consumidos = fin ? largo + 1 : largo;
+    char linea[MAX_CMD];
+    memcpy(linea, con->buffer, largo);
+    linea[largo] = '\0';
+    linea[strcspn(linea, "\r")] = '\0';
+    con->usados -= consumidos;
+    memmove(con->buffer, con->buffer + consumidos, con->usados);
+
+    return responder(srv, id, linea, con->out) && !eof;
+}
+
+/**
+ * @brief Bucle de cada hilo trabajador: toma un pedido de la cola, lo
+ *        responde y devuelve la conexión.
+ *
+ * Si el cliente ya envió otra línea completa, la conexión vuelve al final de
+ * la cola; si no, vuelve al conjunto que vigila el hilo aceptador.
+ */
+static void* trabajador(void* arg) {
+    Trabajador* t = (Trabajador*)arg;
+    Servidor* srv = t->srv;
+
+    while (1) {
+        pthread_mutex_lock(&srv->mutex);
+        while (srv->cantidad == 0 && !srv->detener)
+            pthread_cond_wait(&srv->hay_trabajo, &srv->mutex);
+        if (srv->detener) {
+            pthread_mutex_unlock(&srv->mutex);
+            break;
+        }
+        int i = srv->cola[srv->inicio];
+        srv->inicio = (srv->inicio + 1) % SERVER_COLA;
+        srv->cantidad--;
+        pthread_mutex_unlock(&srv->mutex);
+
+        Conexion* con = &srv->conexiones[i];
+        int abierta = atender_pedido(srv, t->id, con);
+
+        int en_espera = 0;
+        pthread_mutex_lock(&srv->mutex);
+        if (!abierta) {
+            cerrar_conexion(con);
+        } else if (memchr(con->buffer, '\n', con->usados) || con->usados == sizeof(con->buffer) - 1) {
+            encolar(srv, i);
+        } else {
+            con->en_espera = en_espera = 1;
+        }
+        pthread_mutex_unlock(&srv->mutex);
+        if (en_espera) despertar_aceptador(srv);
+    }
+    return NULL;
+}
+
+/* ------------------------------------------------------------------------- */
+/* ------------------------------ SERVE ------------------------------------ */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @brief Crea el socket de escucha en la ruta indicada.
+ *
+ * Si en la ruta ya existe un socket (por ejemplo, de una ejecución anterior
+ * que terminó abruptamente) se reemplaza; cualquier otro tipo de archivo se
+ * respeta y se informa el error.
+ *
+ * @return Descriptor del socket, o -1 en caso de error.
+ */
+static int crear_socket(const char* ruta) {
+    struct sockaddr_un dir;
+    if (strlen(ruta) >= sizeof(dir.sun_path)) {
+        printf("Ruta de socket demasiado larga: %s\n", ruta);
+        return -1;
+    }
+    struct stat st;
+    if (stat(ruta, &st) == 0) {
+        if (!S_ISSOCK(st.st_mode)) {
+            printf("La ruta ya existe y no es un socket: %s\n", ruta);
+            return -1;
+        }
+        unlink(ruta);
+    }
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) { printf("No se pudo crear el socket: %s\n", strerror(errno)); return -1; }
+
+    memset(&dir, 0, sizeof(dir));
+    dir.sun_family = AF_UNIX;
+    strcpy(dir.sun_path, ruta);
+    if (bind(fd, (struct sockaddr*)&dir, sizeof(dir)) < 0 || listen(fd, SERVER_COLA) < 0) {
+        printf("No se pudo escuchar en %s: %s\n", ruta, strerror(errno));
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/**
+ * @brief Registra una conexión recién aceptada en una entrada libre de la tabla.
+ *
+ * La escritura tiene un plazo de SERVER_ESPERA_ENVIO segundos, así un cliente
+ * que deja de leer sus respuestas no retiene a un trabajador indefinidamente.
+ *
+ * @return 1 si se registró, 0 si la tabla está llena o no hubo memoria.
+ */
+static int registrar_conexion(Servidor* srv, int cli) {
+    struct timeval plazo = { SERVER_ESPERA_ENVIO, 0 };
+    setsockopt(cli, SOL_SOCKET, SO_SNDTIMEO, &plazo, sizeof(plazo));
+
+    int registrada = 0;
+    pthread_mutex_lock(&srv->mutex);
+    for (int i = 0; i < SERVER_COLA && !registrada; i++) {
+        Conexion* con = &srv->conexiones[i];
+        if (con->fd >= 0) continue;
+        int fd_out = dup(cli);
+        con->out = (fd_out >= 0) ? fdopen(fd_out, "w") : NULL;
+        if (!con->out) {
+            if (fd_out >= 0) close(fd_out);
+            break;
+        }
+        con->fd = cli;
+        con->usados = 0;
+        con->descartando = 0;
+        con->en_espera = 1;
+        registrada = 1;
+    }
+    pthread_mutex_unlock(&srv->mutex);
+    return registrada;
+}
+
+int bio_serve(const char* ruta, Trie** trie) {
+    if (!*trie || !(*trie)->raiz) { printf("El trie no ha sido inicializado...\n"); return -1; }
+    if (!ruta || ruta[0] == '\0') { printf("Debe indicar la ruta del socket.\n"); return -1; }
+
+    int fd = crear_socket(ruta);
+    if (fd < 0) return -1;
+
+    Servidor srv;
+    if (pipe(srv.despertar) < 0) {
+        printf("No se pudo crear la tuberia del servidor: %s\n", strerror(errno));
+        close(fd);
+        unlink(ruta);
+        return -1;
+    }
+    fcntl(srv.despertar[0], F_SETFL, O_NONBLOCK);
+    fcntl(srv.despertar[1], F_SETFL, O_NONBLOCK);
+
+    /* Un cliente que se desconecta no debe terminar el proceso */
+    void (*sigpipe_anterior)(int) = signal(SIGPIPE, SIG_IGN);
+
+    atomic_init(&srv.indice, *trie);
+    srv.archivo_recarga[0] = '\0';
+    srv.recargando = srv.recarga_terminada = 0;
+    srv.inicio = srv.cantidad = srv.detener = 0;
+    for (int i = 0; i < SERVER_HILOS; i++) atomic_init(&srv.en_uso[i], NULL);
+    for (int i = 0; i < SERVER_COLA; i++) srv.conexiones[i].fd = -1;
+    pthread_mutex_init(&srv.mutex, NULL);
+    pthread_cond_init(&srv.hay_trabajo, NULL);
+
+    pthread_t hilos[SERVER_HILOS];
+    Trabajador args[SERVER_HILOS];
+    int creados = 0;
+    for (int i = 0; i < SERVER_HILOS; i++) {
+        args[i].srv = &srv;
+        args[i].id = i;
+        if (pthread_create(&hilos[i], NULL, trabajador, &args[i]) != 0) break;
+        creados++;
+    }
+    if (creados == 0) {
+        printf("No se pudieron crear los hilos del servidor.\n");
+        srv.detener = 1;
+    } else {
+        printf("Serving on %s\n", ruta);
+        fflush(stdout);
+    }
+
+    /* Aceptar conexiones y encolar las que envían un pedido hasta recibir `bio shutdown` */
+    struct pollfd vigilados[SERVER_COLA + 2];
+    int origen[SERVER_COLA + 2];
+    while (1) {
+        int n = 0;
+        vigilados[n++] = (struct pollfd){ fd, POLLIN, 0 };
+        vigilados[n++] = (struct pollfd){ srv.despertar[0], POLLIN, 0 };
+        pthread_mutex_lock(&srv.mutex);
+        int detener = srv.detener;
+        for (int i = 0; i < SERVER_COLA; i++) {
+            if (srv.conexiones[i].fd < 0 || !srv.conexiones[i].en_espera) continue;
+            origen[n] = i;
+            vigilados[n++] = (struct pollfd){ srv.conexiones[i].fd, POLLIN, 0 };
+        }
+        pthread_mutex_unlock(&srv.mutex);
+        if (detener) break;
+
+        if (poll(vigilados, (nfds_t)n, 200) <= 0) continue;
+        if (vigilados[1].revents) {
+            char descarte[64];
+            while (read(srv.despertar[0], descarte, sizeof(descarte)) > 0) {}
+        }
+
+        /* Datos, cierre o error: un trabajador lo atiende (read() no bloqueará) */
+        pthread_mutex_lock(&srv.mutex);
+        for (int k = 2; k < n; k++) {
+            if (!vigilados[k].revents) continue;
+            srv.conexiones[origen[k]].en_espera = 0;
+            encolar(&srv, origen[k]);
+        }
+        pthread_mutex_unlock(&srv.mutex);
+
+        if (vigilados[0].revents & POLLIN) {
+            int cli = accept(fd, NULL, NULL);
+            if (cli >= 0 && !registrar_conexion(&srv, cli))
+                close(cli); /* Tabla llena: se rechaza la conexión */
+        }
+    }
+
+    solicitar_detencion(&srv);
+    for (int i = 0; i < creados; i++) pthread_join(hilos[i], NULL);
+    if (srv.recargando) pthread_join(srv.hilo_recarga, NULL);
+
+    /* El índice vigente vuelve a la CLI (el original pudo ser reemplazado) */
+    *trie = atomic_load(&srv.indice);
+
+    /* Conexiones que seguían abiertas, en espera o con pedidos sin atender */
+    for (int i = 0; i < SERVER_COLA; i++) {
+        if (srv.conexiones[i].fd >= 0) cerrar_conexion(&srv.conexiones[i]);
+    }
+
+    pthread_cond_destroy(&srv.hay_trabajo);
+    pthread_mutex_destroy(&srv.mutex);
+    close(srv.despertar[0]);
+    close(srv.despertar[1]);
+    close(fd);
+    unlink(ruta);
+    signal(SIGPIPE, sigpipe_anterior);
+    printf("Server stopped\n");
+    return (creados == 0) ? -1 : 0;
+}
+
+#endif
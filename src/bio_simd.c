@@ -0,0 +1,231 @@
+/**
+ * @file bio_simd.c
+ * @brief Implementación de las rutinas vectorizadas de normalización,
+ *        validación y empaquetado de bases.
+ *
+ * Cada operación tiene tres versiones:
+ * - Escalar: válida en cualquier plataforma y usada para los restos.
+ * - SSE2: disponible siempre en x86-64, procesa 16 bytes por iteración.
+ * - AVX2: procesa 32 bytes por iteración; se compila con el atributo
+ *   `target("avx2")` y solo se usa si el procesador lo informa, de modo que
+ *   el ejecutable funciona igual en equipos sin AVX2.
+ */
+
+#include <string.h>
+#include <ctype.h>
+
+#include "bio_simd.h"
+#include "bio_func.h"
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define BIO_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+/* ------------------------------------------------------------------------- */
+/* -------------------------- VERSIONES ESCALARES -------------------------- */
+/* ------------------------------------------------------------------------- */
+
+static size_t normalizar_escalar(char* dst, const char* src, size_t n) {
+    size_t k = 0;
+    for (size_t i = 0; i < n; i++) {
+        unsigned char c = (unsigned char)src[i];
+        if (c == '\n' || c == '\r') continue;
+        dst[k++] = (char)toupper(c);
+    }
+    return k;
+}
+
+static size_t codificar_escalar(uint8_t* codigos, const char* s, size_t n) {
+    size_t invalidos = 0;
+    for (size_t i = 0; i < n; i++) {
+        int idx = char_a_indice(s[i]);
+        if (idx < 0) { codigos[i] = BASE_INVALIDA; invalidos++; }
+        else codigos[i] = (uint8_t)idx;
+    }
+    return invalidos;
+}
+
+static void empaquetar_escalar(uint8_t* dst, const uint8_t* codigos, size_t n) {
+    for (size_t i = 0; i < n; i += 4) {
+        uint8_t byte = 0;
+        for (size_t j = 0; j < 4 && i + j < n; j++)
+            byte |= (uint8_t)((codigos[i + j] & 3u) << (2 * j));
+        dst[i / 4] = byte;
+    }
+}
+
+#ifdef BIO_SIMD_X86
+
+/* ------------------------------------------------------------------------- */
+/* ------------------------------- SSE2 ------------------------------------ */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * @brief Copia un bloque ya convertido omitiendo las posiciones marcadas
+ *        como salto de línea en la máscara.
+ */
+static size_t compactar_bloque(char* dst, const char* bloque, unsigned mascara, int ancho) {
+    size_t k = 0;
+    for (int j = 0; j < ancho; j++)
+        if (!((mascara >> j) & 1u)) dst[k++] = bloque[j];
+    return k;
+}
+
+static size_t normalizar_sse2(char* dst, const char* src, size_t n) {
+    const __m128i lf  = _mm_set1_epi8('\n');
+    const __m128i cr  = _mm_set1_epi8('\r');
+    const __m128i a_1 = _mm_set1_epi8('a' - 1);
+    const __m128i z_1 = _mm_set1_epi8('z' + 1);
+    const __m128i dif = _mm_set1_epi8('a' - 'A');
+    size_t i = 0, k = 0;
+
+    for (; i + 16 <= n; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(src + i));
+        /* Minúsculas: 'a' <= c <= 'z' (bytes >= 0x80 son negativos y no califican) */
+        __m128i min = _mm_and_si128(_mm_cmpgt_epi8(v, a_1), _mm_cmplt_epi8(v, z_1));
+        v = _mm_sub_epi8(v, _mm_and_si128(min, dif));
+        unsigned saltos = (unsigned)_mm_movemask_epi8(
+            _mm_or_si128(_mm_cmpeq_epi8(v, lf), _mm_cmpeq_epi8(v, cr)));
+        if (!saltos) {
+            _mm_storeu_si128((__m128i*)(dst + k), v);
+            k += 16;
+        } else {
+            char bloque[16];
+            _mm_storeu_si128((__m128i*)bloque, v);
+            k += compactar_bloque(dst + k, bloque, saltos, 16);
+        }
+    }
+    return k + normalizar_escalar(dst + k, src + i, n - i);
+}
+
+static size_t codificar_sse2(uint8_t* codigos, const char* s, size_t n) {
+    const __m128i A = _mm_set1_epi8('A'), C = _mm_set1_epi8('C');
+    const __m128i G = _mm_set1_epi8('G'), T = _mm_set1_epi8('T');
+    const __m128i uno = _mm_set1_epi8(1), dos = _mm_set1_epi8(2);
+    const __m128i tres = _mm_set1_epi8(3), inv = _mm_set1_epi8(BASE_INVALIDA);
+    size_t i = 0, invalidos = 0;
+
+    for (; i + 16 <= n; i += 16) {
+        __m128i v  = _mm_loadu_si128((const __m128i*)(s + i));
+        __m128i ea = _mm_cmpeq_epi8(v, A), ec = _mm_cmpeq_epi8(v, C);
+        __m128i eg = _mm_cmpeq_epi8(v, G), et = _mm_cmpeq_epi8(v, T);
+        __m128i cod = _mm_or_si128(_mm_and_si128(ec, uno),
+                      _mm_or_si128(_mm_and_si128(eg, dos), _mm_and_si128(et, tres)));
+        __m128i val = _mm_or_si128(_mm_or_si128(ea, ec), _mm_or_si128(eg, et));
+        cod = _mm_or_si128(cod, _mm_andnot_si128(val, inv));
+        _mm_storeu_si128((__m128i*)(codigos + i), cod);
+        invalidos += (size_t)__builtin_popcount(~(unsigned)_mm_movemask_epi8(val) & 0xFFFFu);
+    }
+    return invalidos + codificar_escalar(codigos + i, s + i, n - i);
+}
+
+static void empaquetar_sse2(uint8_t* dst, const uint8_t* codigos, size_t n) {
+    const __m128i tres = _mm_set1_epi8(3);
+    const __m128i byte = _mm_set1_epi32(0xFF);
+    size_t i = 0;
+
+    for (; i + 16 <= n; i += 16) {
+        /* Cada entero de 32 bits contiene 4 códigos c0..c3, uno por byte */
+        __m128i v = _mm_and_si128(_mm_loadu_si128((const __m128i*)(codigos + i)), tres);
+        /* byte0 = c0 | c1<<2 y byte2 = c2 | c3<<2 */
+        v = _mm_or_si128(v, _mm_srli_epi32(v, 6));
+        /* byte0 = c0 | c1<<2 | c2<<4 | c3<<6 */
+        v = _mm_and_si128(_mm_or_si128(v, _mm_srli_epi32(v, 12)), byte);
+        v = _mm_packs_epi32(v, v);
+        v = _mm_packus_epi16(v, v);
+        uint32_t cuatro = (uint32_t)_mm_cvtsi128_si32(v);
+        memcpy(dst + i / 4, &cuatro, sizeof(cuatro));
+    }
+    empaquetar_escalar(dst + i / 4, codigos + i, n - i);
+}
+
+/* ------------------------------------------------------------------------- */
+/* ------------------------------- AVX2 ------------------------------------ */
+/* ------------------------------------------------------------------------- */
+
+__attribute__((target("avx2")))
+static size_t normalizar_avx2(char* dst, const char* src, size_t n) {
+    const __m256i lf  = _mm256_set1_epi8('\n');
+    const __m256i cr  = _mm256_set1_epi8('\r');
+    const __m256i a_1 = _mm256_set1_epi8('a' - 1);
+    const __m256i z_1 = _mm256_set1_epi8('z' + 1);
+    const __m256i dif = _mm256_set1_epi8('a' - 'A');
+    size_t i = 0, k = 0;
+
+    for (; i + 32 <= n; i += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(src + i));
+        __m256i min = _mm256_and_si256(_mm256_cmpgt_epi8(v, a_1), _mm256_cmpgt_epi8(z_1, v));
+        v = _mm256_sub_epi8(v, _mm256_and_si256(min, dif));
+        unsigned saltos = (unsigned)_mm256_movemask_epi8(
+            _mm256_or_si256(_mm256_cmpeq_epi8(v, lf), _mm256_cmpeq_epi8(v, cr)));
+        if (!saltos) {
+            _mm256_storeu_si256((__m256i*)(dst + k), v);
+            k += 32;
+        } else {
+            char bloque[32];
+            _mm256_storeu_si256((__m256i*)bloque, v);
+            k += compactar_bloque(dst + k, bloque, saltos, 32);
+        }
+    }
+    return k + normalizar_sse2(dst + k, src + i, n - i);
+}
+
+__attribute__((target("avx2")))
+static size_t codificar_avx2(uint8_t* codigos, const char* s, size_t n) {
+    const __m256i A = _mm256_set1_epi8('A'), C = _mm256_set1_epi8('C');
+    const __m256i G = _mm256_set1_epi8('G'), T = _mm256_set1_epi8('T');
+    const __m256i uno = _mm256_set1_epi8(1), dos = _mm256_set1_epi8(2);
+    const __m256i tres = _mm256_set1_epi8(3), inv = _mm256_set1_epi8(BASE_INVALIDA);
+    size_t i = 0, invalidos = 0;
+
+    for (; i + 32 <= n; i += 32) {
+        __m256i v  = _mm256_loadu_si256((const __m256i*)(s + i));
+        __m256i ea = _mm256_cmpeq_epi8(v, A), ec = _mm256_cmpeq_epi8(v, C);
+        __m256i eg = _mm256_cmpeq_epi8(v, G), et = _mm256_cmpeq_epi8(v, T);
+        __m256i cod = _mm256_or_si256(_mm256_and_si256(ec, uno),
+                      _mm256_or_si256(_mm256_and_si256(eg, dos), _mm256_and_si256(et, tres)));
+        __m256i val = _mm256_or_si256(_mm256_or_si256(ea, ec), _mm256_or_si256(eg, et));
+        cod = _mm256_or_si256(cod, _mm256_andnot_si256(val, inv));
+        _mm256_storeu_si256((__m256i*)(codigos + i), cod);
+        invalidos += (size_t)__builtin_popcount(~(unsigned)_mm256_movemask_epi8(val));
+    }
+    return invalidos + codificar_sse2(codigos + i, s + i, n - i);
+}
+
+/**
+ * @brief Indica si el procesador actual soporta AVX2.
+ */
+static int hay_avx2(void) {
+    return __builtin_cpu_supports("avx2");
+}
+
+#endif // BIO_SIMD_X86
+
+/* ------------------------------------------------------------------------- */
+/* -------------------------- FUNCIONES PÚBLICAS --------------------------- */
+/* ------------------------------------------------------------------------- */
+
+size_t normalizar_bases(char* dst, const char* src, size_t n) {
+#ifdef BIO_SIMD_X86
+    return hay_avx2() ? normalizar_avx2(dst, src, n) : normalizar_sse2(dst, src, n);
+#else
+    return normalizar_escalar(dst, src, n);
+#endif
+}
+
+size_t codificar_bases(uint8_t* codigos, const char* s, size_t n) {
+#ifdef BIO_SIMD_X86
+    return hay_avx2() ? codificar_avx2(codigos, s, n) : codificar_sse2(codigos, s, n);
+#else
+    return codificar_escalar(codigos, s, n);
+#endif
+}
+
+void empaquetar_2bits(uint8_t* dst, const uint8_t* codigos, size_t n) {
+#ifdef BIO_SIMD_X86
+    empaquetar_sse2(dst, codigos, n);
+#else
+    empaquetar_escalar(dst, codigos, n);
+#endif
+}
@@ -4,16 +4,22 @@
  *
  * Este archivo inicializa la interfaz de comandos (CLI) del programa,
  * la cual permite ejecutar:
- *  - bio start m
- *  - bio read archivo.txt
+ *  - bio start m [--count-only [bloom]]
+ *  - bio read archivo.txt [sa]
+ *  - bio build archivo.txt --mem-limit MB
+ *  - bio load archivo.idx
  *  - bio search GEN
+ *  - bio prefix PREFIJO
+ *  - bio extract POS LARGO
+ *  - bio compare A B [all]
  *  - bio all
  *  - bio max
  *  - bio min
+ *  - bio serve RUTA
  *  - bio exit
  *
  * La lógica principal y las funciones internas se encuentran en los módulos
- * bio_commands.c, bio_func.c y bio_struct.h. Este archivo únicamente inicia
+ * bio_commands.c, bio_func.c, bio_server.c y bio_struct.h. Este archivo únicamente inicia
  * el flujo de ejecución.
  */
 